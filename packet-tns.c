@@ -15,7 +15,18 @@
 #include <epan/packet.h>
 #include "packet-tcp.h"
 
+#include <epan/conversation.h>
+#include <epan/expert.h>
 #include <epan/prefs.h>
+#include <epan/proto_data.h>
+#include <epan/reassemble.h>
+#include <epan/srt_table.h>
+#include <epan/stat_tap_ui.h>
+#include <epan/tap.h>
+#include <epan/to_str.h>
+#include <wsutil/inet_addr.h>
+#include <wsutil/pint.h>
+#include <wsutil/strtoi.h>
 
 void proto_register_tns(void);
 
@@ -54,6 +65,7 @@ void proto_register_tns(void);
 #define SQLNET_PIGGYBACK_FUNC   17
 #define SQLNET_SIG_4UCS         18
 #define SQLNET_FLUSH_BIND_DATA  19
+#define SQLNET_BIT_VECTOR       21
 #define SQLNET_SNS              0xdeadbeef
 #define SQLNET_XTRN_PROCSERV_R1 32
 #define SQLNET_XTRN_PROCSERV_R2 68
@@ -246,9 +258,193 @@ void proto_register_tns(void);
 #define OPI_OSESSKEY            2
 #define OPI_OAUTH               3
 
+/* First TNS version with a 32 bit packet length (Oracle 12c) */
+#define TNS_VERSION_LARGE_SDU   315
+
+/* Index of the TTC field version in the compile time capabilities */
+#define TTC_CCAP_FIELD_VERSION  7
+
+/*
+ * Statement text with its fingerprint, see tns_sql_normalize(). Statements
+ * differing in literals, blanks, comments or letter case share the
+ * normalized text and fingerprint.
+ */
+typedef struct {
+	const gchar *text;
+	const gchar *normalized;
+	const gchar *verb;            /* NULL if not recognized */
+	guint64 fingerprint;          /* FNV-1a of the normalized text */
+} tns_sql_t;
+
+/*
+ * Cursor opened by a parse call. Entries are chained in least recently
+ * used order, so the table of a conversation can be kept bounded.
+ */
+typedef struct _tns_cursor_t {
+	guint32 cursor_id;
+	guint32 parse_frame;          /* frame that carried the SQL text */
+	const gchar *sql;             /* interned, see tns_intern_sql() */
+	guint32 columns;              /* select list from the describe, 0 if unknown */
+	gboolean plain_columns;       /* all of them length prefixed in rows */
+	guint32 fetches;              /* fetch responses with counted rows */
+	guint64 rows;                 /* rows of those */
+	wmem_tree_t *fetch_sizes;     /* rows -> fetches that did not end the rows */
+	guint32 fetch_samples;        /* fetches in fetch_sizes */
+	gboolean fetch_reported;      /* median shown at an end of fetch */
+	struct _tns_cursor_t *prev;   /* more recently used */
+	struct _tns_cursor_t *next;   /* less recently used */
+} tns_cursor_t;
+
+/*
+ * A client call (OCI function) and the first packet of its response.
+ * Shared by the frame records of both, queued to the SRT tap.
+ */
+typedef struct {
+	guint32 req_frame;
+	guint32 rsp_frame;            /* 0 while unanswered */
+	nstime_t req_time;
+	guint32 oci_func_id;
+	guint32 req_bytes;
+	/* statement parsed or executed by the call, NULL if unknown */
+	const gchar *sql;
+	const tns_sql_t *statement;   /* of sql */
+	guint8 request_type;
+	guint8 data_direction;
+	guint bind_count;
+	guint piggyback_closes;       /* cursors closed ahead of the call */
+	guint32 parse_count;          /* calls of the session with this fingerprint, 0 if no text sent */
+	guint32 cursor_id;            /* executed or fetched from, 0 if new or unknown */
+	guint32 fetch_requested;      /* rows asked for, 0 if unknown */
+	/* rows of the response, first pass, see tns_fetch_response() */
+	guint32 columns;              /* select list of the cursor when answered */
+	gboolean plain_columns;
+	gboolean fetch_counted;       /* rows walked to their end, of a fetch or of an execute returning rows */
+	guint32 fetch_rows;
+	gboolean fetch_end;           /* no more rows pending */
+	guint32 cursor_fetches;       /* totals of the cursor up to the response */
+	guint64 cursor_rows;
+	guint32 cursor_median;        /* rows per fetch of the cursor, at its first end of fetch */
+	guint32 cursor_median_fetches;  /* fetches of that median, 0 if not shown here */
+} tns_call_t;
+
+/*
+ * Record of the "tns" tap, queued once for a call that parses or executes
+ * a known statement and once for its response.
+ */
+typedef struct {
+	const gchar *sql;             /* normalized statement text */
+	guint64 fingerprint;          /* of the statement, keys the statistics */
+	guint8 request_type;          /* TTC/TTI request type */
+	guint8 data_direction;        /* SQLNET_TTCI_STMT_xxx, 0 if unknown */
+	guint bind_count;             /* bind parameters of the statement */
+	guint32 bytes;                /* TNS packet length */
+	guint32 frame;
+	guint32 conv_index;
+	guint32 oci_func_id;          /* of the call */
+	guint piggyback_closes;       /* of the call, requests only */
+	gboolean parse;               /* the call sent the statement text */
+	const gchar *session_user;    /* session identity, NULL if not seen */
+	const gchar *session_sid;
+	guint32 sdu_size;             /* negotiated SDU, 0 if unknown */
+	gboolean fetch_counted;       /* response rows known, responses only */
+	guint32 fetch_rows;
+	gboolean fetch_end;
+	gboolean is_response;
+	nstime_t response_time;       /* since the call, responses only */
+} tns_sql_tap_info_t;
+
+/* Values of the Connect descriptor kept with the session */
+enum {
+	TNS_CD_SERVICE_NAME,
+	TNS_CD_SID,
+	TNS_CD_CID,
+	TNS_CD_PROGRAM,
+	TNS_CD_HOST,
+	TNS_CD_USER,
+	TNS_CD_COUNT
+};
+
+/* Session identity from the authentication exchange */
+enum {
+	TNS_SESSION_USER,
+	TNS_SESSION_SID,
+	TNS_SESSION_SERIAL,
+	TNS_SESSION_PROGRAM,
+	TNS_SESSION_MACHINE,
+	TNS_SESSION_TERMINAL,
+	TNS_SESSION_COUNT
+};
+
+/* Last part of a TTC message being reassembled, see tns_finish_ttc() */
+typedef struct {
+	struct _tns_pdu_info_t *pdu_info;  /* NULL if no message is open */
+	frame_data *fd;
+	nstime_t abs_ts;
+	guint32 pdu_key;
+	guint16 layer_num;
+} tns_ttc_open_t;
+
+/*
+ * Per conversation session state. Filled on the first pass from the
+ * Connect/Accept exchange and the Set Protocol/Set Datatypes messages,
+ * so later packets are framed and decoded without guessing.
+ */
+typedef struct {
+	/* listener side, set for conversations found by the heuristic */
+	address server_addr;
+	guint32 server_port;         /* 0 if unknown, the dissector port is used */
+	guint32 connect_frame;       /* frame of the Connect, 0 if not seen */
+	guint32 accept_frame;        /* frame of the Accept, 0 if not seen */
+	guint16 version;             /* requested, then negotiated TNS version */
+	guint32 sdu_size;            /* requested, then negotiated SDU size */
+	guint16 tdu_size;            /* requested, then negotiated TDU size */
+	guint8  ttc_version;         /* server version from Set Protocol */
+	guint8  ttc_field_version;   /* client TTC field version from Set Datatypes */
+	/* Connect descriptor values, TNS_CD_xxx, NULL if absent */
+	const gchar *connect_values[TNS_CD_COUNT];
+	guint32 connect_data_len;    /* connect data expected in a Data packet, first pass */
+	/* session identity from a frame on, frame -> TNS_SESSION_COUNT values
+	 * (TNS_SESSION_xxx, NULL if not seen) */
+	wmem_tree_t *sessions;
+	/* cursor table, cursor id -> tns_cursor_t */
+	wmem_map_t *cursors;
+	tns_cursor_t *cursor_mru;    /* most recently used */
+	tns_cursor_t *cursor_lru;    /* least recently used, evicted first */
+	/* statement parsed into a new cursor, waiting for the id in the response */
+	const gchar *pending_sql;
+	guint32 pending_frame;
+	/* last client call, waiting for the response */
+	tns_call_t *pending_call;
+	/* statement fingerprint -> calls of the session that sent its text */
+	wmem_map_t *parses;
+	/* TTC message being reassembled, per direction (request, response) */
+	tns_ttc_open_t ttc_open[2];
+} tns_conv_info_t;
+
 /* desegmentation of TNS over TCP */
 static gboolean tns_desegment = TRUE;
 
+/* reassembly of TTC messages spanning several TNS Data packets */
+static gboolean tns_ttc_reassemble = TRUE;
+static reassembly_table tns_ttc_reassembly_table;
+
+#define TNS_DATA_FLAG_MORE 0x0020
+
+static int tns_srt_tap = -1;
+static int tns_tap = -1;
+
+/* maximum number of cursors tracked per conversation */
+#define TNS_CURSOR_CACHE_DEFAULT 4096
+static guint tns_cursor_cache_size = TNS_CURSOR_CACHE_DEFAULT;
+
+/* fetches returning fewer rows while more are pending are flagged */
+#define TNS_FETCH_ROWS_THRESHOLD_DEFAULT 10
+static guint tns_fetch_rows_threshold = TNS_FETCH_ROWS_THRESHOLD_DEFAULT;
+
+/* SQL text of all cursors, each distinct statement is stored once,
+ * text -> tns_sql_t */
+static wmem_map_t *tns_sql_texts;
+
 static dissector_handle_t tns_handle;
 
 static int proto_tns = -1;
@@ -276,6 +472,7 @@ static int hf_tns_sopt_flag_ra = -1;
 static int hf_tns_sopt_flag_sa = -1;
 
 static int hf_tns_sdu_size = -1;
+static int hf_tns_sdu_size_large = -1;
 static int hf_tns_max_tdu_size = -1;
 
 static int hf_tns_nt_proto_characteristics = -1;
@@ -311,6 +508,12 @@ static int hf_tns_conn_flag_ichg = -1;
 static int hf_tns_conn_flag_wantna = -1;
 
 static int hf_tns_connect_data = -1;
+static int hf_tns_connect_service_name = -1;
+static int hf_tns_connect_sid = -1;
+static int hf_tns_connect_cid = -1;
+static int hf_tns_connect_program = -1;
+static int hf_tns_connect_host = -1;
+static int hf_tns_connect_user = -1;
 static int hf_tns_trace_cf1 = -1;
 static int hf_tns_trace_cf2 = -1;
 static int hf_tns_trace_cid = -1;
@@ -334,6 +537,8 @@ static int hf_tns_marker_data_byte = -1;
 
 static int hf_tns_redirect_data_length = -1;
 static int hf_tns_redirect_data = -1;
+static int hf_tns_redirect_host = -1;
+static int hf_tns_redirect_port = -1;
 
 static int hf_tns_control_cmd = -1;
 static int hf_tns_control_data = -1;
@@ -363,12 +568,52 @@ static int hf_tns_data_opi_num_of_params = -1;
 static int hf_tns_data_opi_param_length = -1;
 static int hf_tns_data_opi_param_name = -1;
 static int hf_tns_data_opi_param_value = -1;
+static int hf_tns_session_user = -1;
+static int hf_tns_session_sid = -1;
+static int hf_tns_session_serial = -1;
+static int hf_tns_session_program = -1;
+static int hf_tns_session_machine = -1;
+static int hf_tns_session_terminal = -1;
+
+static int hf_tns_parse_count = -1;
+static int hf_tns_sql_fingerprint = -1;
+static int hf_tns_sql_verb = -1;
+
+static int hf_tns_fetch_requested = -1;
+static int hf_tns_fetch_columns = -1;
+static int hf_tns_fetch_rows = -1;
+static int hf_tns_fetch_end = -1;
+static int hf_tns_fetch_cursor_fetches = -1;
+static int hf_tns_fetch_cursor_rows = -1;
+static int hf_tns_fetch_cursor_median = -1;
 
 static int hf_tns_data_setp_acc_version = -1;
 static int hf_tns_data_setp_cli_plat = -1;
 static int hf_tns_data_setp_version = -1;
 static int hf_tns_data_setp_banner = -1;
 
+static int hf_tns_data_sdty_ttc_field_version = -1;
+
+static int hf_tns_data_cursor_id = -1;
+static int hf_tns_data_cursor_sql = -1;
+static int hf_tns_data_cursor_parse_frame = -1;
+static int hf_tns_data_cursor_closed = -1;
+
+static int hf_tns_ttc_fragments = -1;
+static int hf_tns_ttc_fragment = -1;
+static int hf_tns_ttc_fragment_overlap = -1;
+static int hf_tns_ttc_fragment_overlap_conflicts = -1;
+static int hf_tns_ttc_fragment_multiple_tails = -1;
+static int hf_tns_ttc_fragment_too_long_fragment = -1;
+static int hf_tns_ttc_fragment_error = -1;
+static int hf_tns_ttc_fragment_count = -1;
+static int hf_tns_ttc_reassembled_in = -1;
+static int hf_tns_ttc_reassembled_length = -1;
+
+static int hf_tns_response_in = -1;
+static int hf_tns_response_to = -1;
+static int hf_tns_time = -1;
+
 static int hf_tns_data_sns_cli_vers = -1;
 static int hf_tns_data_sns_srv_vers = -1;
 static int hf_tns_data_sns_srvcnt = -1;
@@ -381,30 +626,31 @@ static int hf_tns_data_ttic_req_type = -1;
 static int hf_tns_data_ttic_pkt_unknown_3 = -1;
 static int hf_tns_data_ttic_data_direction = -1;
 static int hf_tns_data_ttic_param_count = -1;
+static int hf_tns_oall8_token = -1;
+static int hf_tns_oall8_options = -1;
+static int hf_tns_oall8_cursor = -1;
+static int hf_tns_oall8_sql_length = -1;
+static int hf_tns_oall8_al8i4_length = -1;
+static int hf_tns_oall8_prefetch_rows = -1;
+static int hf_tns_oall8_max_long_size = -1;
+static int hf_tns_oall8_bind_count = -1;
+static int hf_tns_oall8_define_count = -1;
 static int hf_tns_data_ttic_stmt_sql = -1;
-/* I don't know how to register hf... dynamicly */
-static int hf_tns_data_ttic_stmt_sql_p01 = -1;
-static int hf_tns_data_ttic_stmt_sql_p02 = -1;
-static int hf_tns_data_ttic_stmt_sql_p03 = -1;
-static int hf_tns_data_ttic_stmt_sql_p04 = -1;
-static int hf_tns_data_ttic_stmt_sql_p05 = -1;
-static int hf_tns_data_ttic_stmt_sql_p06 = -1;
-static int hf_tns_data_ttic_stmt_sql_p07 = -1;
-static int hf_tns_data_ttic_stmt_sql_p08 = -1;
-static int hf_tns_data_ttic_stmt_sql_p09 = -1;
-static int hf_tns_data_ttic_stmt_sql_p10 = -1;
-static int hf_tns_data_ttic_stmt_sql_p11 = -1;
-static int hf_tns_data_ttic_stmt_sql_p12 = -1;
-static int hf_tns_data_ttic_stmt_sql_p13 = -1;
-static int hf_tns_data_ttic_stmt_sql_p14 = -1;
-static int hf_tns_data_ttic_stmt_sql_p15 = -1;
-static int hf_tns_data_ttic_stmt_sql_p16 = -1;
-static int hf_tns_data_ttic_stmt_sql_p17 = -1;
-static int hf_tns_data_ttic_stmt_sql_p18 = -1;
-static int hf_tns_data_ttic_stmt_sql_p19 = -1;
-static int hf_tns_data_ttic_stmt_sql_p20 = -1;
+/* bind values, one subtree per bind */
+static int hf_tns_bind_index = -1;
+static int hf_tns_bind_type = -1;
+static int hf_tns_bind_length = -1;
+static int hf_tns_bind_value = -1;
+static int hf_tns_bind_data = -1;
+static int hf_tns_bind_number = -1;
+static int hf_tns_bind_integer = -1;
+static int hf_tns_bind_time = -1;
+static int hf_tns_bind_tz_offset = -1;
 /* TTC/TTI END ====================================== */
 
+static expert_field ei_tns_parse_repeated = EI_INIT;
+static expert_field ei_tns_fetch_rows_low = EI_INIT;
+
 static gint ett_tns = -1;
 static gint ett_tns_connect = -1;
 static gint ett_tns_accept = -1;
@@ -424,6 +670,26 @@ static gint ett_tns_ntp_flag = -1;
 static gint ett_tns_conn_flag = -1;
 static gint ett_sql = -1;
 static gint ett_sql_params = -1; /* TTC/TTI */
+static gint ett_sql_bind = -1;
+static gint ett_tns_ttc_fragment = -1;
+static gint ett_tns_ttc_fragments = -1;
+
+static const fragment_items tns_ttc_frag_items = {
+	&ett_tns_ttc_fragment,
+	&ett_tns_ttc_fragments,
+	&hf_tns_ttc_fragments,
+	&hf_tns_ttc_fragment,
+	&hf_tns_ttc_fragment_overlap,
+	&hf_tns_ttc_fragment_overlap_conflicts,
+	&hf_tns_ttc_fragment_multiple_tails,
+	&hf_tns_ttc_fragment_too_long_fragment,
+	&hf_tns_ttc_fragment_error,
+	&hf_tns_ttc_fragment_count,
+	&hf_tns_ttc_reassembled_in,
+	&hf_tns_ttc_reassembled_length,
+	NULL,
+	"TTC fragments"
+};
 
 #define TCP_PORT_TNS			1521 /* Not IANA registered */
 
@@ -487,6 +753,7 @@ static const value_string tns_data_funcs[] = {
 	{SQLNET_PIGGYBACK_FUNC,   "Piggy back function follow"},
 	{SQLNET_SIG_4UCS,         "Signals special action for untrusted callout support"},
 	{SQLNET_FLUSH_BIND_DATA,  "Flush Out Bind data in DML/w RETURN when error"},
+	{SQLNET_BIT_VECTOR,       "Bit Vector"},
 	{SQLNET_XTRN_PROCSERV_R1, "External Procedures and Services Registrations"},
 	{SQLNET_XTRN_PROCSERV_R2, "External Procedures and Services Registrations"},
 	{SQLNET_SNS,              "Secure Network Services"},
@@ -731,6 +998,67 @@ static guint get_data_func_id(tvbuff_t *tvb, int offset)
 	}
 }
 
+static tns_conv_info_t *tns_conversation_get_info(conversation_t *conversation)
+{
+	tns_conv_info_t *tns_info;
+
+	tns_info = (tns_conv_info_t *) conversation_get_proto_data(conversation, proto_tns);
+	if (!tns_info)
+	{
+		tns_info = wmem_new0(wmem_file_scope(), tns_conv_info_t);
+		tns_info->cursors = wmem_map_new(wmem_file_scope(), g_direct_hash, g_direct_equal);
+		tns_info->parses = wmem_map_new(wmem_file_scope(), g_int64_hash, g_int64_equal);
+		tns_info->sessions = wmem_tree_new(wmem_file_scope());
+		conversation_add_proto_data(conversation, proto_tns, tns_info);
+	}
+
+	return tns_info;
+}
+
+static tns_conv_info_t *tns_get_conv_info(packet_info *pinfo)
+{
+	return tns_conversation_get_info(find_or_create_conversation(pinfo));
+}
+
+/* Session identity as of the frame, TNS_SESSION_COUNT values or NULL if none is known */
+static const gchar *const *tns_session_values(packet_info *pinfo, const tns_conv_info_t *tns_info)
+{
+	return (const gchar *const *) wmem_tree_lookup32_le(tns_info->sessions, pinfo->num);
+}
+
+/* Was the packet sent by the client? */
+static gboolean tns_is_request(packet_info *pinfo, const tns_conv_info_t *tns_info)
+{
+	if ( tns_info->server_port != 0 )
+	{
+		return pinfo->destport == tns_info->server_port &&
+		       addresses_equal(&pinfo->dst, &tns_info->server_addr);
+	}
+
+	return pinfo->match_uint == pinfo->destport;
+}
+
+/*
+ * Size of the packet length field. From TNS version 315 (Oracle 12c) on,
+ * every packet after the Accept carries a 32 bit length in place of the
+ * former length and packet checksum words. Without a negotiated version
+ * (capture started mid-session) guess it from the checksum word, which is
+ * generally 0, or 4 for some 10g clients, when the length has 16 bit.
+ */
+static guint tns_length_field_size(tvbuff_t *tvb, packet_info *pinfo, tns_conv_info_t *tns_info)
+{
+	guint16 chksum;
+
+	if ( tns_info->accept_frame != 0 && pinfo->num > tns_info->accept_frame )
+	{
+		return tns_info->version >= TNS_VERSION_LARGE_SDU ? 4 : 2;
+	}
+
+	chksum = tvb_get_ntohs(tvb, 2);
+
+	return (chksum == 0 || chksum == 4) ? 2 : 4;
+}
+
 static void vsnum_to_vstext_basecustom(gchar *result, guint32 vsnum)
 {
 	/*
@@ -745,6 +1073,85 @@ static void vsnum_to_vstext_basecustom(gchar *result, guint32 vsnum)
 		 vsnum & 0xff);
 }
 
+/**
+ * @brief Reader over a span of a tvb that is checked once
+ *
+ * The TTC structures are made of many small fields. Instead of one tvb
+ * accessor call (bounds check, exception setup) per field, the span is
+ * fetched with a single tvb_get_ptr() and the fields are decoded from
+ * memory. Reading past the span throws the exception tvb would have.
+ */
+typedef struct {
+	tvbuff_t *tvb;
+	const guint8 *data;
+	gint offset;        /* tvb offset of data[0] */
+	gint length;
+	gint pos;           /* read position, relative to offset */
+} tns_span_t;
+
+/* Span of up to length bytes at offset, clipped to the captured data */
+static void tns_span_init(tns_span_t *span, tvbuff_t *tvb, gint offset, gint length)
+{
+	gint captured = tvb_captured_length_remaining(tvb, offset);
+
+	if ( captured < 0 )
+		captured = 0;
+
+	span->tvb = tvb;
+	span->offset = offset;
+	span->length = MIN(length, captured);
+	span->data = tvb_get_ptr(tvb, offset, span->length);
+	span->pos = 0;
+}
+
+static inline void tns_span_ensure(const tns_span_t *span, gint length)
+{
+	if ( G_UNLIKELY(span->pos + length > span->length) )
+	{
+		/* throws BoundsError or ReportedBoundsError as appropriate */
+		tvb_ensure_bytes_exist(span->tvb, span->offset + span->pos, length);
+		THROW(ReportedBoundsError);
+	}
+}
+
+static inline guint8 tns_span_get_guint8(tns_span_t *span)
+{
+	tns_span_ensure(span, 1);
+	return span->data[span->pos++];
+}
+
+static inline guint16 tns_span_get_ntohs(tns_span_t *span)
+{
+	guint16 value;
+
+	tns_span_ensure(span, 2);
+	value = pntoh16(&span->data[span->pos]);
+	span->pos += 2;
+	return value;
+}
+
+static inline guint16 tns_span_get_letohs(tns_span_t *span)
+{
+	guint16 value;
+
+	tns_span_ensure(span, 2);
+	value = pletoh16(&span->data[span->pos]);
+	span->pos += 2;
+	return value;
+}
+
+static inline void tns_span_skip(tns_span_t *span, gint length)
+{
+	tns_span_ensure(span, length);
+	span->pos += length;
+}
+
+/* tvb offset of the read position */
+static inline gint tns_span_offset(const tns_span_t *span)
+{
+	return span->offset + span->pos;
+}
+
 /**
  * SQL statement parameter header
  * Oracle 12 
@@ -768,6 +1175,29 @@ typedef struct ttci_param_header {
 	uint8_t unknown_7;
 } ttci_stmt_pd_hdr_t;
 
+/* The header block was formerly memcpy'd into the structure above, so the
+ * wire size and field positions follow its in-memory layout (padding after
+ * 'type' and 'unknown_7') and the 16 bit words are read little-endian. */
+#define TTCI_STMT_PD_HDR_LEN 18
+
+static void ttci_get_stmt_pd_hdr(tvbuff_t *tvb, int offset, ttci_stmt_pd_hdr_t *hdr)
+{
+	tns_span_t span;
+
+	tns_span_init(&span, tvb, offset, TTCI_STMT_PD_HDR_LEN);
+	hdr->unknown_1 = tns_span_get_letohs(&span);
+	hdr->direction = tns_span_get_guint8(&span);
+	hdr->flags     = tns_span_get_guint8(&span);
+	hdr->unknown_2 = tns_span_get_letohs(&span);
+	hdr->unknown_3 = tns_span_get_letohs(&span);
+	hdr->unknown_4 = tns_span_get_letohs(&span);
+	hdr->unknown_5 = tns_span_get_letohs(&span);
+	hdr->type      = tns_span_get_guint8(&span);
+	tns_span_skip(&span, 1);
+	hdr->unknown_6 = tns_span_get_letohs(&span);
+	hdr->unknown_7 = tns_span_get_guint8(&span);
+}
+
 /**
  * SQL statement parameter descriptor 
  *                         ..... ..... type.
@@ -807,6 +1237,33 @@ typedef struct {
 	} param_marker;
 } ttci_stmt_pd_itm_t;
 
+/* Longest parameter descriptor: magic, flags, properties and markers,
+ * plus the reread marker word */
+#define TTCI_STMT_PD_ITM_MAX_LEN 18
+
+/* Bind value kinds, derived from the parameter descriptor */
+#define TTCI_BIND_NUMBER   0
+#define TTCI_BIND_STRING   1
+#define TTCI_BIND_DATETIME 2
+
+static const value_string ttci_bind_kinds[] = {
+	{TTCI_BIND_NUMBER, "Number"},
+	{TTCI_BIND_STRING, "String"},
+	{TTCI_BIND_DATETIME, "Date/Time"},
+	{0, NULL}
+};
+
+/**
+ * @brief Location of one bind value in the parameter value list
+ */
+typedef struct {
+	gint offset;     /* offset of the length byte or chunk marker */
+	guint32 length;  /* logical value length */
+	guint32 span;    /* bytes on the wire, from offset */
+	guint8 kind;     /* TTCI_BIND_xxx */
+	gboolean chunked;
+} ttci_bind_t;
+
 /**
  * @brief TTC/TTI packet structure (work in progress!)
  */
@@ -827,665 +1284,4394 @@ typedef struct {
 	uint16_t unknown_5;
 	uint8_t stmt_byte4;
 	uint8_t stmt_flags;
-	uint8_t param_count;
+	guint32 param_count;
 	uint16_t unknown_6;
 	uint16_t unknown_7;
 	uint8_t stmt_sel_unk1;
 	uint8_t stmt_sel_unk2;
+	/* parse results, independent of the protocol tree */
+	gint oall8_offset;      /* sequence byte of an OALL8 call, -1 if none */
+	gboolean oall8_decoded; /* header decoded by ttci_decode_oall8() */
+	guint32 parse_count;       /* text sent by the session so far, 0 if none */
+	guint32 fetch_cursor_id;   /* cursor of an OALL8 or fetch call */
+	guint32 fetch_rows;        /* rows asked for by it, 0 if unknown */
+	guint8 parse_state;     /* TTCI_PARSED_xxx */
+	gint unknown_3_offset;  /* -1 if the header was too short */
+	gint direction_offset;  /* -1 if absent */
+	gint param_count_offset;
+	gint stmt_offset;       /* text, or chunk marker if chunked */
+	gint stmt_length;       /* 0 if no statement was found */
+	gboolean stmt_chunked;
+	guint8 ttc_field_version;  /* of the session, selects the chunk format */
+	gint end_offset;        /* first byte behind the parsed part */
+	guint bind_count;
+	ttci_bind_t *binds;     /* file scope, kept with the frame record */
 } ttci_packet_t;
 
-//#define _DISSECTOR_SQL_DEBUG
+/* Parse progress of a TTC/TTI record */
+#define TTCI_PARSED_NONE   0
+#define TTCI_PARSED_STMT   1   /* statement header and text located */
+#define TTCI_PARSED_BINDS  2   /* bind values located as well */
 
-/* TCC/TCI Parse SQL parameter block */
-static int dissect_tns_data_sql_params(tvbuff_t *tvb, proto_tree *data_tree _U_, int offset, ttci_packet_t* pttci)
-{
-	int* hf_prop_ref_list[] = {
-		&hf_tns_data_ttic_stmt_sql_p01,
-		&hf_tns_data_ttic_stmt_sql_p02,
-		&hf_tns_data_ttic_stmt_sql_p03,
-		&hf_tns_data_ttic_stmt_sql_p04,
-		&hf_tns_data_ttic_stmt_sql_p05,
-		&hf_tns_data_ttic_stmt_sql_p06,
-		&hf_tns_data_ttic_stmt_sql_p07,
-		&hf_tns_data_ttic_stmt_sql_p08,
-		&hf_tns_data_ttic_stmt_sql_p09,
-		&hf_tns_data_ttic_stmt_sql_p10,
-		&hf_tns_data_ttic_stmt_sql_p11,
-		&hf_tns_data_ttic_stmt_sql_p12,
-		&hf_tns_data_ttic_stmt_sql_p13,
-		&hf_tns_data_ttic_stmt_sql_p14,
-		&hf_tns_data_ttic_stmt_sql_p15,
-		&hf_tns_data_ttic_stmt_sql_p16,
-		&hf_tns_data_ttic_stmt_sql_p17,
-		&hf_tns_data_ttic_stmt_sql_p18,
-		&hf_tns_data_ttic_stmt_sql_p19,
-		&hf_tns_data_ttic_stmt_sql_p20,
-		NULL,
-	};
+/**
+ * @brief Per PDU results of the first pass, see tns_get_pdu_info()
+ */
+typedef struct _tns_pdu_info_t {
+	ttci_packet_t *ttci;          /* SQL statement record, NULL if not parsed */
+	wmem_map_t *cursors;          /* item offset -> tns_cursor_ref_t, of the referenced cursors */
+	tns_call_t *call;             /* call this PDU starts or answers */
+	gboolean ttc_fragment;        /* part of a TTC message in several packets */
+	gboolean ttc_more;            /* not the last part of it */
+	gboolean connect_data;        /* Data packet with the connect data of the Connect */
+} tns_pdu_info_t;
+
+/* Statement of a cursor referenced in a PDU, as of the first pass */
+typedef struct {
+	const gchar *sql;
+	guint32 parse_frame;
+} tns_cursor_ref_t;
 
-	ttci_stmt_pd_hdr_t* pd_header;
-	ttci_stmt_pd_itm_t* pd_list;
-	proto_tree* pd_tree;
-	proto_item *pi;
-	proto_item *ti;
-	uint8_t* byte_buffer;
-	int buff_offset;
-	int bytes_remaining;
-	int pd_list_size;
-	#ifdef _DISSECTOR_SQL_DEBUG
-	int pd_header_size;
-	#endif
+/* Key of the number of TNS PDUs dissected so far in the frame, kept in
+ * the packet scope so every pass counts from zero */
+#define TNS_PROTO_DATA_PDU_COUNT 0
 
-	/* get remaining bytes of packet buffer */
-	bytes_remaining = tvb_reported_length_remaining(tvb, offset);
+/* Count the PDU being dissected, see tns_find_pdu_info() */
+static void tns_start_pdu(packet_info *pinfo)
+{
+	guint count;
 
-	/* size of parameter descriptor list plus value list marker entry */
-	pd_list_size = sizeof(ttci_stmt_pd_itm_t) * (pttci->param_count + 1);
-	
-#ifdef _DISSECTOR_SQL_DEBUG
-	/* size of static statement parameter header */
-	pd_header_size = sizeof(ttci_stmt_pd_hdr_t);
+	count = GPOINTER_TO_UINT(p_get_proto_data(pinfo->pool, pinfo, proto_tns, TNS_PROTO_DATA_PDU_COUNT));
+	p_add_proto_data(pinfo->pool, pinfo, proto_tns, TNS_PROTO_DATA_PDU_COUNT, GUINT_TO_POINTER(count + 1));
+}
 
-	fprintf(stdout, "%s: TTCI(offset=0x%04x) SQL:PARAMS:START pdhs=%d pdls=%d remaining=%d +++++++\n", 
-		__func__, offset, pd_header_size, pd_list_size, bytes_remaining);
-#endif
+/*
+ * Frame record of a TNS PDU, holding what the first pass has parsed or
+ * resolved from the conversation state. A TCP segment may carry more
+ * than one TNS PDU, all dissected at the same protocol layer, so the
+ * record is keyed by the position of the PDU in the frame. PDUs are
+ * dissected in the same order on every pass.
+ */
+static guint32 tns_pdu_key(packet_info *pinfo)
+{
+	guint count;
 
-	/* at least header size + one parameter marker */
-	if ( bytes_remaining > (int) (sizeof(ttci_stmt_pd_hdr_t) + 6) ) 
-	{
-		/* allocate packet buffer */
-		if ( !(pd_header = malloc(sizeof(ttci_stmt_pd_hdr_t))) )
-		{
-			fprintf(stderr, "%s: TTC/TTI: Out of memory. Abort!\n", __func__);
-			goto exit_done;
-		}
-		memset(pd_header, 0, sizeof(ttci_stmt_pd_hdr_t));
+	count = GPOINTER_TO_UINT(p_get_proto_data(pinfo->pool, pinfo, proto_tns, TNS_PROTO_DATA_PDU_COUNT));
+	return count > 0 ? count - 1 : 0;
+}
 
-		/* allocate parameter descriptor list */
-		if (!(pd_list = malloc(pd_list_size)))
-		{
-			fprintf(stderr, "%s: TTC/TTI: Out of memory. Abort!\n", __func__);
-			goto exit_cleanup;
-		}
-		memset(pd_list, 0, pd_list_size);
+static tns_pdu_info_t *tns_find_pdu_info(packet_info *pinfo)
+{
+	return (tns_pdu_info_t *) p_get_proto_data(wmem_file_scope(), pinfo, proto_tns, tns_pdu_key(pinfo));
+}
 
-		/* get SQL parameter header block */
-		pd_header = (ttci_stmt_pd_hdr_t*) tvb_memcpy(tvb, pd_header, offset, sizeof(ttci_stmt_pd_hdr_t));
+static tns_pdu_info_t *tns_get_pdu_info(packet_info *pinfo)
+{
+	tns_pdu_info_t *pdu_info;
 
-#ifdef _DISSECTOR_SQL_DEBUG
+	pdu_info = tns_find_pdu_info(pinfo);
+	if ( !pdu_info )
+	{
+		pdu_info = wmem_new0(wmem_file_scope(), tns_pdu_info_t);
+		p_add_proto_data(wmem_file_scope(), pinfo, proto_tns, tns_pdu_key(pinfo), pdu_info);
+	}
 
-		fprintf(stdout, "%s: TTCI(offset=0x%04x) param_count=%d direction=0x%02x "
-						"flags=0x%02x type=0x%02x u1=0x%04x u2=0x%04x u3=0x%04x u4=0x%04x u5=0x%04x\n", 
-			__func__, offset, 
-			pttci->param_count,
-			pd_header->direction,
-			pd_header->flags,
-			pd_header->type,
-			pd_header->unknown_1,
-			pd_header->unknown_2,
-			pd_header->unknown_3,
-			pd_header->unknown_4,
-			pd_header->unknown_5);
-#endif
+	return pdu_info;
+}
 
-		/* set offset of the parameter descriptor block */
-		if (pd_header->unknown_5 == 0x8002) {
-			/* header is one byte to short. found in sql 
-			 * statement with 1 parameter. */
-			buff_offset = offset + sizeof(ttci_stmt_pd_hdr_t) - 1;
-		} else {
-			buff_offset = offset + sizeof(ttci_stmt_pd_hdr_t);
-		}
+/*
+ * Pair a client call with the first server packet that follows it. TTC
+ * has a single call outstanding per session, so the conversation keeps
+ * the last unanswered call only.
+ */
+static void tns_match_call(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree,
+			   tns_conv_info_t *tns_info, gboolean is_request, guint32 oci_func_id,
+			   const ttci_packet_t *pttci, const gchar *sql, guint piggyback_closes)
+{
+	tns_pdu_info_t *pdu_info;
+	tns_sql_tap_info_t *tap_info;
+	tns_call_t *call;
+	proto_item *pi;
 
-		/* set offset end of parameter descriptor header */
-		int bytes = tvb_reported_length_remaining(tvb, buff_offset);
-		bool found = false;
-		
-		/* find first parameter block */
-		if ( bytes > 4 ) do 
+	if ( !PINFO_FD_VISITED(pinfo) )
+	{
+		if ( is_request )
 		{
-			pd_list[0].magic_1 = tvb_get_guint16(tvb, buff_offset, ENC_BIG_ENDIAN);
-			pd_list[0].magic_2 = tvb_get_guint16(tvb, buff_offset + 2, ENC_BIG_ENDIAN);
-			if (pd_list[0].magic_1 == 0x0300 && pd_list[0].magic_2 == 0x001) 
-			{
-				found = true;
-				break;
-			} 
-
-#ifdef _DISSECTOR_SQL_DEBUG
-			fprintf(stdout, "%s: TTCI(offset=0x%04x) magic_1=0x%04x magic_2=0x%04x\n", 
-				__func__, buff_offset, pd_list[0].magic_1, pd_list[0].magic_2);
-#endif			
-			bytes -= 1;
-			buff_offset += 1;	
-		} while (bytes > 0);
-
-		if (!found) {
-			fprintf(stderr, "%s: TTC/TTI: Parameter descriptor not found. Abort! bytes_remaining=%d buff_offset=%d\n",
-				__func__, bytes_remaining, buff_offset);
-			goto exit_clenup_list;
+			call = wmem_new0(wmem_file_scope(), tns_call_t);
+			call->req_frame = pinfo->num;
+			call->req_time = pinfo->abs_ts;
+			call->oci_func_id = oci_func_id;
+			call->req_bytes = tvb_reported_length(tvb);
+			call->sql = sql;
+			call->statement = sql ? (const tns_sql_t *) wmem_map_lookup(tns_sql_texts, sql) : NULL;
+			call->request_type = pttci->request_type;
+			call->data_direction = pttci->data_direction;
+			call->bind_count = pttci->param_count;
+			call->piggyback_closes = piggyback_closes;
+			call->parse_count = pttci->parse_count;
+			call->cursor_id = pttci->fetch_cursor_id;
+			call->fetch_requested = pttci->fetch_rows;
+			tns_get_pdu_info(pinfo)->call = call;
+			tns_info->pending_call = call;
 		}
-
-		/* load parameter descriptors */
-		for (int j = 0; j < pttci->param_count; j++) 
+		else if ( tns_info->pending_call )
 		{
-			pd_list[j].magic_1 = tvb_get_guint16(tvb, buff_offset, ENC_BIG_ENDIAN);
-			buff_offset += 2;
+			call = tns_info->pending_call;
+			call->rsp_frame = pinfo->num;
+			tns_get_pdu_info(pinfo)->call = call;
+			tns_info->pending_call = NULL;
+		}
+	}
 
-			pd_list[j].magic_2 = tvb_get_guint16(tvb, buff_offset, ENC_BIG_ENDIAN);
-			buff_offset += 2;
+	pdu_info = tns_find_pdu_info(pinfo);
+	if ( !pdu_info || !pdu_info->call )
+	{
+		return;
+	}
+	call = pdu_info->call;
 
-			pd_list[j].flags = tvb_get_guint8 (tvb, buff_offset);
-			buff_offset += 1;
+	if ( call->statement )
+	{
+		const gchar *const *session = tns_session_values(pinfo, tns_info);
+
+		tap_info = wmem_new0(pinfo->pool, tns_sql_tap_info_t);
+		tap_info->sql = call->statement->normalized;
+		tap_info->fingerprint = call->statement->fingerprint;
+		tap_info->request_type = call->request_type;
+		tap_info->data_direction = call->data_direction;
+		tap_info->bind_count = call->bind_count;
+		tap_info->bytes = tvb_reported_length(tvb);
+		tap_info->frame = pinfo->num;
+		tap_info->conv_index = find_or_create_conversation(pinfo)->conv_index;
+		tap_info->oci_func_id = call->oci_func_id;
+		tap_info->piggyback_closes = call->piggyback_closes;
+		tap_info->sdu_size = tns_info->sdu_size;
+		tap_info->fetch_counted = call->fetch_counted;
+		tap_info->fetch_rows = call->fetch_rows;
+		tap_info->fetch_end = call->fetch_end;
+		tap_info->parse = call->parse_count > 0;
+		tap_info->session_user = session ? session[TNS_SESSION_USER] : NULL;
+		tap_info->session_sid = session ? session[TNS_SESSION_SID] : NULL;
+	}
+	else
+	{
+		tap_info = NULL;
+	}
 
-			/* end of descriptor list reached */
-			if (pd_list[j].magic_1 != 0x0300 && pd_list[j].magic_2 != 0x0001)
-			{
-				fprintf(stderr, "%s: TTC/TTI: Invalid parameter descriptor detected. Abort! offs=0x%04x ma1=0x%04x ma2=0x%04x flags=0x%02x\n",
-					__func__, buff_offset, pd_list[j].magic_1, pd_list[j].magic_2, pd_list[j].flags);
-				goto exit_clenup_list;
-			}
-			
-			/* number/date/time parameter types: */
-			if (pd_list[j].flags == 0x16 || pd_list[j].flags == 0x07)
-			{
-				pd_list[j].param_props.unknown_1 = tvb_get_guint16(tvb, buff_offset, ENC_BIG_ENDIAN);
-				buff_offset += 2;
-				pd_list[j].param_props.unknown_2 = tvb_get_guint8(tvb, buff_offset);
-				buff_offset += 1;
-				pd_list[j].param_props.unknown_3 = tvb_get_guint8(tvb, buff_offset);
-				buff_offset += 1;
-
-				pd_list[j].param_marker.marker_1 = tvb_get_guint16(tvb, buff_offset, ENC_BIG_ENDIAN);
-				buff_offset += 2;
-				pd_list[j].param_marker.marker_2 = tvb_get_guint16(tvb, buff_offset, ENC_BIG_ENDIAN);
-				buff_offset += 2;
-				pd_list[j].param_marker.marker_3 = tvb_get_guint16(tvb, buff_offset, ENC_BIG_ENDIAN);
-				buff_offset += 2;
-			}
-			/* parameter type: */
-			else {
-				pd_list[j].param_props.unknown_1 = tvb_get_guint16(tvb, buff_offset, ENC_BIG_ENDIAN);
-				buff_offset += 2;
-				pd_list[j].param_props.unknown_2 = tvb_get_guint8(tvb, buff_offset);
-				buff_offset += 1;
-				pd_list[j].param_props.unknown_3 = tvb_get_guint16(tvb, buff_offset, ENC_BIG_ENDIAN);
-				buff_offset += 2;
-
-				pd_list[j].param_marker.marker_1 = tvb_get_guint16(tvb, buff_offset, ENC_BIG_ENDIAN);
-				buff_offset += 2;
-				pd_list[j].param_marker.marker_2 = tvb_get_guint16(tvb, buff_offset, ENC_BIG_ENDIAN);
-				buff_offset += 2;
-				pd_list[j].param_marker.marker_3 = tvb_get_guint16(tvb, buff_offset, ENC_BIG_ENDIAN);
-				buff_offset += 2;
+	if ( call->req_frame == pinfo->num )
+	{
+		if ( call->rsp_frame )
+		{
+			pi = proto_tree_add_uint(tree, hf_tns_response_in, tvb, 0, 0, call->rsp_frame);
+			proto_item_set_generated(pi);
+		}
 
-				if (pd_list[j].flags == 0x01 && pd_list[j].magic_2 == 0x0109)
-				{
-					/* reread marker 3 word */
-					pd_list[j].param_marker.marker_3 = tvb_get_guint16(tvb, buff_offset, ENC_BIG_ENDIAN);
-					buff_offset += 2;
-				}
-			}
-			
-#ifdef _DISSECTOR_SQL_DEBUG
-			fprintf(stdout, "%s: TTCI(offset=0x%04x) >> p=%d ma1=0x%04x ma2=0x%04x flags=0x%02x pu1=0x%04x pu2=0x%02x pu3=0x%04x pm1=0x%04x pm2=0x%04x pm3=0x%04x\n", 
-				__func__, buff_offset, j + 1,
-				pd_list[j].magic_1,
-				pd_list[j].magic_2,
-				pd_list[j].flags,
-				pd_list[j].param_props.unknown_1,
-				pd_list[j].param_props.unknown_2,
-				pd_list[j].param_props.unknown_3,
-				pd_list[j].param_marker.marker_1,
-				pd_list[j].param_marker.marker_2,
-				pd_list[j].param_marker.marker_3);
-#endif
-			/* parameter value list marker reached */
-			if (pd_list[j].param_marker.marker_2 == 0x6901 && pd_list[j].param_marker.marker_3 == 0x0007)
+		/* a statement parsed over and over instead of re-executing its
+		 * cursor, the client does not cache statements */
+		if ( call->parse_count > 0 )
+		{
+			pi = proto_tree_add_uint(tree, hf_tns_parse_count, tvb, 0, 0, call->parse_count);
+			proto_item_set_generated(pi);
+			if ( call->parse_count > 1 )
 			{
-#ifdef _DISSECTOR_SQL_DEBUG
-				fprintf(stdout, "%s: TTCI(offset=0x%04x) buff_offset=0x%04x *** VALUE LIST REACHED ***\n", 
-					__func__, offset, buff_offset);
-#endif
-				break;
+				expert_add_info_format(pinfo, pi, &ei_tns_parse_repeated,
+					"Statement parsed %u times in this session", call->parse_count);
 			}
 		}
+	}
+	else
+	{
+		nstime_t delta;
 
-		/* set start of prameter value list */
-		offset = buff_offset;
+		pi = proto_tree_add_uint(tree, hf_tns_response_to, tvb, 0, 0, call->req_frame);
+		proto_item_set_generated(pi);
 
-		/* get remaining bytes of packet buffer */
-		if (!(bytes_remaining = tvb_reported_length_remaining(tvb, offset)))
+		nstime_delta(&delta, &pinfo->abs_ts, &call->req_time);
+		pi = proto_tree_add_time(tree, hf_tns_time, tvb, 0, 0, &delta);
+		proto_item_set_generated(pi);
+
+		tap_queue_packet(tns_srt_tap, pinfo, call);
+
+		if ( tap_info )
 		{
-			goto exit_clenup_list;
+			tap_info->is_response = TRUE;
+			tap_info->response_time = delta;
 		}
+	}
 
-#ifdef _DISSECTOR_SQL_DEBUG
-		fprintf(stdout, "%s: TTCI(offset=0x%04x) SQL:VALUES:START remaining=%d +++++++\n", 
-			__func__, offset, bytes_remaining);
-#endif
-		int* hf_prop_ref;
-		char numbuf[1024];
-		pd_tree = proto_tree_add_subtree(data_tree, tvb, offset, -1, ett_sql_params, &ti, "TTC/TTI SQL Parameters");
+	if ( tap_info )
+	{
+		tap_queue_packet(tns_tap, pinfo, tap_info);
+	}
+}
 
-		for (int i=0, param_idx=0, value_len=0;
-			 i < bytes_remaining && param_idx < pttci->param_count && hf_prop_ref_list[param_idx]; 
-			 param_idx++, i += value_len)
-		{
-			if ( tvb_reported_length_remaining(tvb, offset) <= 0 )
-			{
-				fprintf(stderr, "%s: TTC/TTI: No bytes left, Abort!\n", __func__);
-				goto exit_clenup_list;				
-			}
+static void tns_srt_init(struct register_srt* srt _U_, GArray* srt_array)
+{
+	srt_stat_table *tns_srt_table;
 
-			hf_prop_ref = hf_prop_ref_list[param_idx];
-			value_len = tvb_get_guint8(tvb, offset);
-			offset += 1;
+	tns_srt_table = init_srt_table("TNS OCI Functions", NULL, srt_array, 256, "Function", "tns.data_oci.id", NULL);
+	for (int i = 0; i < 256; i++)
+	{
+		init_srt_table_row(tns_srt_table, i, val_to_str_ext_const(i, &tns_data_oci_subfuncs_ext, "Unknown"));
+	}
+}
 
-			/* valid value length */
-			if ( !value_len )
-			{
-				fprintf(stderr, "%s: TTC/TTI: Invalid parameter value length detected. Abort!\n", __func__);
-				goto exit_clenup_list;				
-			}
+static tap_packet_status tns_srt_packet(void *pss, packet_info *pinfo, epan_dissect_t *edt _U_, const void *prv, tap_flags_t flags _U_)
+{
+	srt_data_t *data = (srt_data_t *) pss;
+	const tns_call_t *call = (const tns_call_t *) prv;
+	srt_stat_table *tns_srt_table;
+
+	tns_srt_table = g_array_index(data->srt_array, srt_stat_table*, 0);
+	add_srt_table_data(tns_srt_table, call->oci_func_id, &call->req_time, pinfo);
+
+	return TAP_PACKET_REDRAW;
+}
+
+/*
+ * Rows of the statistics tables by key. The row data of a table starts
+ * with tns_stat_row_t and is extended by the tables that keep more. It
+ * is owned by the table itself: each row holds its data in the scratch
+ * space of its first item, the first row holds the key map of the table
+ * as well, and both are freed with those items. So several instances of
+ * a table (dialogs, -z arguments) keep rows of their own.
+ */
+typedef struct {
+	guint row;
+	GHashTable *index;            /* key -> row data of all rows, first row only */
+} tns_stat_row_t;
+
+/* Key of the statistics tables of the statements */
+static gpointer tns_stat_key(guint64 fingerprint)
+{
+	guint64 *key = g_new(guint64, 1);
+
+	*key = fingerprint;
+	return key;
+}
+
+/* Create the table, or reset it if it exists */
+static void tns_stat_init(stat_tap_table_ui* new_stat, const char *table_name)
+{
+	stat_tap_table *table;
+
+	table = stat_tap_find_table(new_stat, table_name);
+	if ( table )
+	{
+		if ( new_stat->stat_tap_reset_table_cb )
+		{
+			new_stat->stat_tap_reset_table_cb(table);
+		}
+		return;
+	}
+
+	table = stat_tap_init_table(table_name, (int) new_stat->nfields, 0, NULL);
+	stat_tap_add_table(new_stat, table);
+}
+
+/* Data of a row */
+static tns_stat_row_t *tns_stat_row(stat_tap_table *table, guint row)
+{
+	return (tns_stat_row_t *) stat_tap_get_field_data(table, row, 0)->user_data.ptr_value;
+}
+
+/* Row of the key, NULL if there is none yet */
+static tns_stat_row_t *tns_stat_lookup(stat_tap_table *table, gconstpointer key)
+{
+	if ( table->num_elements == 0 )
+	{
+		return NULL;
+	}
+	return (tns_stat_row_t *) g_hash_table_lookup(tns_stat_row(table, 0)->index, key);
+}
+
+/*
+ * Append the row of a key to the table. The key (g_malloc'd) and the row
+ * data (row_size bytes, zeroed) are owned by the table afterwards, the
+ * key functions are those of the table. The items hold the values of the
+ * key columns, the types of all are taken from the fields of the table.
+ */
+static tns_stat_row_t *tns_stat_add(stat_data_t *stat_data, stat_tap_table *table, gpointer key,
+				    GHashFunc key_hash, GEqualFunc key_equal, gsize row_size,
+				    stat_tap_table_item_type *items)
+{
+	const stat_tap_table_ui *ui = stat_data->stat_tap_data;
+	tns_stat_row_t *row;
+
+	for (guint col = 0; col < ui->nfields; col++)
+	{
+		items[col].type = ui->fields[col].type;
+	}
+
+	row = (tns_stat_row_t *) g_malloc0(row_size);
+	row->row = table->num_elements;
+	if ( row->row == 0 )
+	{
+		row->index = g_hash_table_new_full(key_hash, key_equal, g_free, NULL);
+	}
+	items[0].user_data.ptr_value = row;
+	stat_tap_init_table_row(table, row->row, (guint) ui->nfields, items);
+	g_hash_table_insert(tns_stat_row(table, 0)->index, key, row);
+
+	return row;
+}
+
+/* Zero the numbers of all rows from a column on, strings are left alone */
+static void tns_stat_reset(stat_tap_table* table, guint first_col)
+{
+	stat_tap_table_item_type *item;
+
+	for (guint row = 0; row < table->num_elements; row++)
+	{
+		for (guint col = first_col; col < table->num_fields; col++)
+		{
+			item = stat_tap_get_field_data(table, row, col);
+			if ( item->type == TABLE_ITEM_FLOAT )
+				item->value.float_value = 0.0;
+			else if ( item->type == TABLE_ITEM_UINT )
+				item->value.uint_value = 0;
+			else
+				continue;
+			stat_tap_set_field_data(table, row, col, item);
+		}
+	}
+}
+
+/* Free the row data with the first item of its row, the key map with the first row */
+static void tns_stat_free_item(guint column, stat_tap_table_item_type* field_data, GDestroyNotify row_free)
+{
+	tns_stat_row_t *row = (tns_stat_row_t *) field_data->user_data.ptr_value;
+
+	if ( column != 0 || !row )
+	{
+		return;
+	}
+	if ( row->index )
+	{
+		g_hash_table_destroy(row->index);
+	}
+	if ( row_free )
+		row_free(row);
+	else
+		g_free(row);
+	field_data->user_data.ptr_value = NULL;
+}
+
+/* Statistics > TNS > SQL Statements, one row per statement text */
+enum {
+	TNS_SQL_STAT_COL_SQL = 0,
+	TNS_SQL_STAT_COL_CALLS,
+	TNS_SQL_STAT_COL_BYTES,
+	TNS_SQL_STAT_COL_RESPONSES,
+	TNS_SQL_STAT_COL_MIN_TIME,
+	TNS_SQL_STAT_COL_MAX_TIME,
+	TNS_SQL_STAT_COL_AVG_TIME,
+	TNS_SQL_STAT_COL_SUM_TIME
+};
+
+static stat_tap_table_item tns_sql_stat_fields[] = {
+	{TABLE_ITEM_STRING, TAP_ALIGN_LEFT,  "SQL Statement", "%-60s"},
+	{TABLE_ITEM_UINT,   TAP_ALIGN_RIGHT, "Calls", "%u"},
+	{TABLE_ITEM_UINT,   TAP_ALIGN_RIGHT, "Bytes", "%u"},
+	{TABLE_ITEM_UINT,   TAP_ALIGN_RIGHT, "Responses", "%u"},
+	{TABLE_ITEM_FLOAT,  TAP_ALIGN_RIGHT, "Min Time (s)", "%.6f"},
+	{TABLE_ITEM_FLOAT,  TAP_ALIGN_RIGHT, "Max Time (s)", "%.6f"},
+	{TABLE_ITEM_FLOAT,  TAP_ALIGN_RIGHT, "Avg Time (s)", "%.6f"},
+	{TABLE_ITEM_FLOAT,  TAP_ALIGN_RIGHT, "Sum Time (s)", "%.6f"}
+};
+
+/* rows keyed by statement fingerprint */
+static void tns_sql_stat_init(stat_tap_table_ui* new_stat)
+{
+	tns_stat_init(new_stat, "TNS SQL Statements");
+}
+
+static tap_packet_status tns_sql_stat_packet(void *tapdata, packet_info *pinfo _U_, epan_dissect_t *edt _U_, const void *data, tap_flags_t flags _U_)
+{
+	stat_data_t *stat_data = (stat_data_t *) tapdata;
+	const tns_sql_tap_info_t *tap_info = (const tns_sql_tap_info_t *) data;
+	stat_tap_table *table;
+	stat_tap_table_item_type *item;
+	tns_stat_row_t *stat_row;
+	guint row;
+
+	table = g_array_index(stat_data->stat_tap_data->tables, stat_tap_table*, 0);
+
+	stat_row = tns_stat_lookup(table, &tap_info->fingerprint);
+	if ( !stat_row )
+	{
+		stat_tap_table_item_type items[array_length(tns_sql_stat_fields)];
+
+		memset(items, 0, sizeof(items));
+		items[TNS_SQL_STAT_COL_SQL].value.string_value = g_strdup(tap_info->sql);
+		stat_row = tns_stat_add(stat_data, table, tns_stat_key(tap_info->fingerprint), g_int64_hash, g_int64_equal,
+			sizeof(tns_stat_row_t), items);
+	}
+	row = stat_row->row;
+
+	item = stat_tap_get_field_data(table, row, TNS_SQL_STAT_COL_BYTES);
+	item->value.uint_value += tap_info->bytes;
+	stat_tap_set_field_data(table, row, TNS_SQL_STAT_COL_BYTES, item);
+
+	if ( !tap_info->is_response )
+	{
+		item = stat_tap_get_field_data(table, row, TNS_SQL_STAT_COL_CALLS);
+		item->value.uint_value++;
+		stat_tap_set_field_data(table, row, TNS_SQL_STAT_COL_CALLS, item);
+	}
+	else
+	{
+		double time = nstime_to_sec(&tap_info->response_time);
+		guint responses;
+		double sum;
+
+		item = stat_tap_get_field_data(table, row, TNS_SQL_STAT_COL_RESPONSES);
+		responses = ++item->value.uint_value;
+		stat_tap_set_field_data(table, row, TNS_SQL_STAT_COL_RESPONSES, item);
+
+		item = stat_tap_get_field_data(table, row, TNS_SQL_STAT_COL_MIN_TIME);
+		if ( responses == 1 || time < item->value.float_value )
+		{
+			item->value.float_value = time;
+			stat_tap_set_field_data(table, row, TNS_SQL_STAT_COL_MIN_TIME, item);
+		}
+
+		item = stat_tap_get_field_data(table, row, TNS_SQL_STAT_COL_MAX_TIME);
+		if ( time > item->value.float_value )
+		{
+			item->value.float_value = time;
+			stat_tap_set_field_data(table, row, TNS_SQL_STAT_COL_MAX_TIME, item);
+		}
+
+		item = stat_tap_get_field_data(table, row, TNS_SQL_STAT_COL_SUM_TIME);
+		sum = item->value.float_value += time;
+		stat_tap_set_field_data(table, row, TNS_SQL_STAT_COL_SUM_TIME, item);
+
+		item = stat_tap_get_field_data(table, row, TNS_SQL_STAT_COL_AVG_TIME);
+		item->value.float_value = sum / responses;
+		stat_tap_set_field_data(table, row, TNS_SQL_STAT_COL_AVG_TIME, item);
+	}
+
+	return TAP_PACKET_REDRAW;
+}
+
+static void tns_sql_stat_reset(stat_tap_table* table)
+{
+	tns_stat_reset(table, TNS_SQL_STAT_COL_CALLS);
+}
+
+static void tns_sql_stat_free_table_item(stat_tap_table* table _U_, guint row _U_, guint column, stat_tap_table_item_type* field_data)
+{
+	if ( column == TNS_SQL_STAT_COL_SQL )
+	{
+		g_free((char *) field_data->value.string_value);
+	}
+	tns_stat_free_item(column, field_data, NULL);
+}
+
+static tap_param tns_sql_stat_params[] = {
+	{ PARAM_FILTER, "filter", "Filter", NULL, TRUE }
+};
+
+static stat_tap_table_ui tns_sql_stat_table = {
+	REGISTER_PACKET_STAT_GROUP_UNSORTED,
+	"TNS/SQL Statements",
+	"tns",
+	"tns,sql",
+	tns_sql_stat_init,
+	tns_sql_stat_packet,
+	tns_sql_stat_reset,
+	tns_sql_stat_free_table_item,
+	NULL,
+	array_length(tns_sql_stat_fields), tns_sql_stat_fields,
+	array_length(tns_sql_stat_params), tns_sql_stat_params,
+	NULL,
+	0
+};
+
+/*
+ * Statistics > TNS > Round Trips, one row per statement text. A round
+ * trip is a call answered by the server. Calls with many round trips per
+ * execution (small fetch sizes, separate closes) or with little data per
+ * round trip compared to the SDU point at latency spent in the network.
+ */
+enum {
+	TNS_RTT_STAT_COL_SQL = 0,
+	TNS_RTT_STAT_COL_EXECUTIONS,
+	TNS_RTT_STAT_COL_FETCHES,
+	TNS_RTT_STAT_COL_CLOSES,
+	TNS_RTT_STAT_COL_ROUND_TRIPS,
+	TNS_RTT_STAT_COL_RT_PER_EXEC,
+	TNS_RTT_STAT_COL_BYTES,
+	TNS_RTT_STAT_COL_BYTES_PER_RT,
+	TNS_RTT_STAT_COL_SDU_USE
+};
+
+static stat_tap_table_item tns_rtt_stat_fields[] = {
+	{TABLE_ITEM_STRING, TAP_ALIGN_LEFT,  "SQL Statement", "%-60s"},
+	{TABLE_ITEM_UINT,   TAP_ALIGN_RIGHT, "Executions", "%u"},
+	{TABLE_ITEM_UINT,   TAP_ALIGN_RIGHT, "Fetches", "%u"},
+	{TABLE_ITEM_UINT,   TAP_ALIGN_RIGHT, "Piggybacked Closes", "%u"},
+	{TABLE_ITEM_UINT,   TAP_ALIGN_RIGHT, "Round Trips", "%u"},
+	{TABLE_ITEM_FLOAT,  TAP_ALIGN_RIGHT, "Round Trips/Execution", "%.2f"},
+	{TABLE_ITEM_UINT,   TAP_ALIGN_RIGHT, "Bytes", "%u"},
+	{TABLE_ITEM_FLOAT,  TAP_ALIGN_RIGHT, "Bytes/Round Trip", "%.1f"},
+	{TABLE_ITEM_FLOAT,  TAP_ALIGN_RIGHT, "SDU Use (%)", "%.1f"}
+};
+
+/* Row of a statement, with the totals the derived columns are made of */
+typedef struct {
+	tns_stat_row_t stat;
+	guint64 sdu_capacity;         /* SDU bytes of the packets, 0 if unknown */
+} tns_rtt_stat_row_t;
+
+/* rows keyed by statement fingerprint */
+static void tns_rtt_stat_init(stat_tap_table_ui* new_stat)
+{
+	tns_stat_init(new_stat, "TNS Round Trips");
+}
+
+static tap_packet_status tns_rtt_stat_packet(void *tapdata, packet_info *pinfo _U_, epan_dissect_t *edt _U_, const void *data, tap_flags_t flags _U_)
+{
+	stat_data_t *stat_data = (stat_data_t *) tapdata;
+	const tns_sql_tap_info_t *tap_info = (const tns_sql_tap_info_t *) data;
+	stat_tap_table *table;
+	stat_tap_table_item_type *item;
+	tns_rtt_stat_row_t *row;
+	guint executions, round_trips, bytes;
+
+	table = g_array_index(stat_data->stat_tap_data->tables, stat_tap_table*, 0);
+
+	row = (tns_rtt_stat_row_t *) tns_stat_lookup(table, &tap_info->fingerprint);
+	if ( !row )
+	{
+		stat_tap_table_item_type items[array_length(tns_rtt_stat_fields)];
+
+		memset(items, 0, sizeof(items));
+		items[TNS_RTT_STAT_COL_SQL].value.string_value = g_strdup(tap_info->sql);
+		row = (tns_rtt_stat_row_t *) tns_stat_add(stat_data, table, tns_stat_key(tap_info->fingerprint),
+			g_int64_hash, g_int64_equal, sizeof(tns_rtt_stat_row_t), items);
+	}
+
+	if ( !tap_info->is_response )
+	{
+		guint col = 0;
+
+		if ( tap_info->oci_func_id == SQLNET_USER_FUNC_OALL8 )
+			col = TNS_RTT_STAT_COL_EXECUTIONS;
+		else if ( tap_info->oci_func_id == SQLNET_USER_FUNC_OFETCH )
+			col = TNS_RTT_STAT_COL_FETCHES;
+
+		if ( col != 0 )
+		{
+			item = stat_tap_get_field_data(table, row->stat.row, col);
+			item->value.uint_value++;
+			stat_tap_set_field_data(table, row->stat.row, col, item);
+		}
+
+		item = stat_tap_get_field_data(table, row->stat.row, TNS_RTT_STAT_COL_CLOSES);
+		item->value.uint_value += tap_info->piggyback_closes;
+		stat_tap_set_field_data(table, row->stat.row, TNS_RTT_STAT_COL_CLOSES, item);
+	}
+	else
+	{
+		item = stat_tap_get_field_data(table, row->stat.row, TNS_RTT_STAT_COL_ROUND_TRIPS);
+		item->value.uint_value++;
+		stat_tap_set_field_data(table, row->stat.row, TNS_RTT_STAT_COL_ROUND_TRIPS, item);
+	}
+
+	item = stat_tap_get_field_data(table, row->stat.row, TNS_RTT_STAT_COL_BYTES);
+	bytes = item->value.uint_value += tap_info->bytes;
+	stat_tap_set_field_data(table, row->stat.row, TNS_RTT_STAT_COL_BYTES, item);
+
+	/* a message larger than the SDU fills several packets */
+	if ( tap_info->sdu_size > 0 )
+	{
+		row->sdu_capacity += (guint64) tap_info->sdu_size *
+			MAX(1, (tap_info->bytes + tap_info->sdu_size - 1) / tap_info->sdu_size);
+	}
+
+	executions = stat_tap_get_field_data(table, row->stat.row, TNS_RTT_STAT_COL_EXECUTIONS)->value.uint_value;
+	round_trips = stat_tap_get_field_data(table, row->stat.row, TNS_RTT_STAT_COL_ROUND_TRIPS)->value.uint_value;
+
+	if ( executions > 0 )
+	{
+		item = stat_tap_get_field_data(table, row->stat.row, TNS_RTT_STAT_COL_RT_PER_EXEC);
+		item->value.float_value = (double) round_trips / executions;
+		stat_tap_set_field_data(table, row->stat.row, TNS_RTT_STAT_COL_RT_PER_EXEC, item);
+	}
+	if ( round_trips > 0 )
+	{
+		item = stat_tap_get_field_data(table, row->stat.row, TNS_RTT_STAT_COL_BYTES_PER_RT);
+		item->value.float_value = (double) bytes / round_trips;
+		stat_tap_set_field_data(table, row->stat.row, TNS_RTT_STAT_COL_BYTES_PER_RT, item);
+	}
+	if ( row->sdu_capacity > 0 )
+	{
+		item = stat_tap_get_field_data(table, row->stat.row, TNS_RTT_STAT_COL_SDU_USE);
+		item->value.float_value = 100.0 * bytes / row->sdu_capacity;
+		stat_tap_set_field_data(table, row->stat.row, TNS_RTT_STAT_COL_SDU_USE, item);
+	}
+
+	return TAP_PACKET_REDRAW;
+}
+
+static void tns_rtt_stat_reset(stat_tap_table* table)
+{
+	tns_stat_reset(table, TNS_RTT_STAT_COL_EXECUTIONS);
+
+	for (guint row = 0; row < table->num_elements; row++)
+	{
+		((tns_rtt_stat_row_t *) tns_stat_row(table, row))->sdu_capacity = 0;
+	}
+}
+
+static void tns_rtt_stat_free_table_item(stat_tap_table* table _U_, guint row _U_, guint column, stat_tap_table_item_type* field_data)
+{
+	if ( column == TNS_RTT_STAT_COL_SQL )
+	{
+		g_free((char *) field_data->value.string_value);
+	}
+	tns_stat_free_item(column, field_data, NULL);
+}
+
+static tap_param tns_rtt_stat_params[] = {
+	{ PARAM_FILTER, "filter", "Filter", NULL, TRUE }
+};
+
+static stat_tap_table_ui tns_rtt_stat_table = {
+	REGISTER_PACKET_STAT_GROUP_UNSORTED,
+	"TNS/Round Trips",
+	"tns",
+	"tns,rtt",
+	tns_rtt_stat_init,
+	tns_rtt_stat_packet,
+	tns_rtt_stat_reset,
+	tns_rtt_stat_free_table_item,
+	NULL,
+	array_length(tns_rtt_stat_fields), tns_rtt_stat_fields,
+	array_length(tns_rtt_stat_params), tns_rtt_stat_params,
+	NULL,
+	0
+};
+
+/*
+ * Rows per fetch, counted per value so the median is found by walking
+ * the values in ascending order. Fetches ask for a fixed array size,
+ * there are few distinct values.
+ */
+static void tns_fetch_sizes_add(wmem_tree_t *sizes, guint32 rows)
+{
+	guint count;
+
+	count = GPOINTER_TO_UINT(wmem_tree_lookup32(sizes, rows));
+	wmem_tree_insert32(sizes, rows, GUINT_TO_POINTER(count + 1));
+}
+
+typedef struct {
+	guint32 index;                /* of the median in ascending order, left to skip */
+	guint32 median;
+} tns_fetch_median_t;
+
+static gboolean tns_fetch_median_step(const void *key, void *value, void *userdata)
+{
+	tns_fetch_median_t *median = (tns_fetch_median_t *) userdata;
+	guint count = GPOINTER_TO_UINT(value);
+
+	if ( median->index < count )
+	{
+		median->median = GPOINTER_TO_UINT(key);
+		return TRUE;
+	}
+	median->index -= count;
+	return FALSE;
+}
+
+/* Median of the given number of fetches, the upper one of an even count */
+static guint32 tns_fetch_median(wmem_tree_t *sizes, guint32 fetches)
+{
+	tns_fetch_median_t median = { fetches / 2, 0 };
+
+	wmem_tree_foreach(sizes, tns_fetch_median_step, &median);
+	return median.median;
+}
+
+/*
+ * Statistics > TNS > Fetch Sizes, rows per fetch response of each
+ * statement. The median leaves out the responses that ended the rows,
+ * those return less than the array size by nature. A median below the
+ * threshold means the client fetches in small arrays.
+ */
+enum {
+	TNS_FETCH_STAT_COL_SQL = 0,
+	TNS_FETCH_STAT_COL_FETCHES,
+	TNS_FETCH_STAT_COL_ROWS,
+	TNS_FETCH_STAT_COL_AVG,
+	TNS_FETCH_STAT_COL_MEDIAN,
+	TNS_FETCH_STAT_COL_MAX,
+	TNS_FETCH_STAT_COL_LOW
+};
+
+static stat_tap_table_item tns_fetch_stat_fields[] = {
+	{TABLE_ITEM_STRING, TAP_ALIGN_LEFT,  "SQL Statement", "%-60s"},
+	{TABLE_ITEM_UINT,   TAP_ALIGN_RIGHT, "Fetches", "%u"},
+	{TABLE_ITEM_UINT,   TAP_ALIGN_RIGHT, "Rows", "%u"},
+	{TABLE_ITEM_FLOAT,  TAP_ALIGN_RIGHT, "Avg Rows/Fetch", "%.1f"},
+	{TABLE_ITEM_UINT,   TAP_ALIGN_RIGHT, "Median Rows/Fetch", "%u"},
+	{TABLE_ITEM_UINT,   TAP_ALIGN_RIGHT, "Max Rows/Fetch", "%u"},
+	{TABLE_ITEM_STRING, TAP_ALIGN_LEFT,  "Below Threshold", "%s"}
+};
+
+/* Row of a statement with the rows of its fetches that did not end the rows */
+typedef struct {
+	tns_stat_row_t stat;
+	wmem_tree_t *sizes;           /* rows -> fetches, see tns_fetch_sizes_add() */
+	guint32 samples;              /* fetches in sizes */
+} tns_fetch_stat_row_t;
+
+static void tns_fetch_stat_row_free(gpointer data)
+{
+	tns_fetch_stat_row_t *row = (tns_fetch_stat_row_t *) data;
+
+	wmem_tree_destroy(row->sizes, FALSE, FALSE);
+	g_free(row);
+}
+
+/* rows keyed by statement fingerprint */
+static void tns_fetch_stat_init(stat_tap_table_ui* new_stat)
+{
+	tns_stat_init(new_stat, "TNS Fetch Sizes");
+}
+
+static tap_packet_status tns_fetch_stat_packet(void *tapdata, packet_info *pinfo _U_, epan_dissect_t *edt _U_, const void *data, tap_flags_t flags _U_)
+{
+	stat_data_t *stat_data = (stat_data_t *) tapdata;
+	const tns_sql_tap_info_t *tap_info = (const tns_sql_tap_info_t *) data;
+	stat_tap_table *table;
+	stat_tap_table_item_type *item;
+	tns_fetch_stat_row_t *row;
+	guint fetches, rows;
+
+	if ( !tap_info->is_response || !tap_info->fetch_counted )
+	{
+		return TAP_PACKET_DONT_REDRAW;
+	}
+
+	table = g_array_index(stat_data->stat_tap_data->tables, stat_tap_table*, 0);
+
+	row = (tns_fetch_stat_row_t *) tns_stat_lookup(table, &tap_info->fingerprint);
+	if ( !row )
+	{
+		stat_tap_table_item_type items[array_length(tns_fetch_stat_fields)];
+
+		memset(items, 0, sizeof(items));
+		items[TNS_FETCH_STAT_COL_SQL].value.string_value = g_strdup(tap_info->sql);
+		items[TNS_FETCH_STAT_COL_LOW].value.string_value = "";
+		row = (tns_fetch_stat_row_t *) tns_stat_add(stat_data, table, tns_stat_key(tap_info->fingerprint),
+			g_int64_hash, g_int64_equal, sizeof(tns_fetch_stat_row_t), items);
+		row->sizes = wmem_tree_new(NULL);
+	}
+
+	item = stat_tap_get_field_data(table, row->stat.row, TNS_FETCH_STAT_COL_FETCHES);
+	fetches = ++item->value.uint_value;
+	stat_tap_set_field_data(table, row->stat.row, TNS_FETCH_STAT_COL_FETCHES, item);
+
+	item = stat_tap_get_field_data(table, row->stat.row, TNS_FETCH_STAT_COL_ROWS);
+	rows = item->value.uint_value += tap_info->fetch_rows;
+	stat_tap_set_field_data(table, row->stat.row, TNS_FETCH_STAT_COL_ROWS, item);
+
+	item = stat_tap_get_field_data(table, row->stat.row, TNS_FETCH_STAT_COL_AVG);
+	item->value.float_value = (double) rows / fetches;
+	stat_tap_set_field_data(table, row->stat.row, TNS_FETCH_STAT_COL_AVG, item);
+
+	item = stat_tap_get_field_data(table, row->stat.row, TNS_FETCH_STAT_COL_MAX);
+	if ( tap_info->fetch_rows > item->value.uint_value )
+	{
+		item->value.uint_value = tap_info->fetch_rows;
+		stat_tap_set_field_data(table, row->stat.row, TNS_FETCH_STAT_COL_MAX, item);
+	}
+
+	if ( !tap_info->fetch_end )
+	{
+		guint32 median;
+
+		tns_fetch_sizes_add(row->sizes, tap_info->fetch_rows);
+		median = tns_fetch_median(row->sizes, ++row->samples);
+
+		item = stat_tap_get_field_data(table, row->stat.row, TNS_FETCH_STAT_COL_MEDIAN);
+		item->value.uint_value = median;
+		stat_tap_set_field_data(table, row->stat.row, TNS_FETCH_STAT_COL_MEDIAN, item);
+
+		item = stat_tap_get_field_data(table, row->stat.row, TNS_FETCH_STAT_COL_LOW);
+		item->value.string_value = median < tns_fetch_rows_threshold ? "yes" : "";
+		stat_tap_set_field_data(table, row->stat.row, TNS_FETCH_STAT_COL_LOW, item);
+	}
+
+	return TAP_PACKET_REDRAW;
+}
+
+static void tns_fetch_stat_reset(stat_tap_table* table)
+{
+	stat_tap_table_item_type *item;
+	tns_fetch_stat_row_t *stat_row;
+
+	tns_stat_reset(table, TNS_FETCH_STAT_COL_FETCHES);
+	for (guint row = 0; row < table->num_elements; row++)
+	{
+		item = stat_tap_get_field_data(table, row, TNS_FETCH_STAT_COL_LOW);
+		item->value.string_value = "";
+		stat_tap_set_field_data(table, row, TNS_FETCH_STAT_COL_LOW, item);
+
+		stat_row = (tns_fetch_stat_row_t *) tns_stat_row(table, row);
+		wmem_tree_destroy(stat_row->sizes, FALSE, FALSE);
+		stat_row->sizes = wmem_tree_new(NULL);
+		stat_row->samples = 0;
+	}
+}
+
+static void tns_fetch_stat_free_table_item(stat_tap_table* table _U_, guint row _U_, guint column, stat_tap_table_item_type* field_data)
+{
+	if ( column == TNS_FETCH_STAT_COL_SQL )
+	{
+		g_free((char *) field_data->value.string_value);
+	}
+	tns_stat_free_item(column, field_data, tns_fetch_stat_row_free);
+}
+
+static tap_param tns_fetch_stat_params[] = {
+	{ PARAM_FILTER, "filter", "Filter", NULL, TRUE }
+};
+
+static stat_tap_table_ui tns_fetch_stat_table = {
+	REGISTER_PACKET_STAT_GROUP_UNSORTED,
+	"TNS/Fetch Sizes",
+	"tns",
+	"tns,fetch",
+	tns_fetch_stat_init,
+	tns_fetch_stat_packet,
+	tns_fetch_stat_reset,
+	tns_fetch_stat_free_table_item,
+	NULL,
+	array_length(tns_fetch_stat_fields), tns_fetch_stat_fields,
+	array_length(tns_fetch_stat_params), tns_fetch_stat_params,
+	NULL,
+	0
+};
+
+/*
+ * Statistics > TNS > Parses, per session and statement the execute calls
+ * that sent the statement text (a parse on the server) against the ones
+ * that re-executed a cursor. A parse share near 100% on a statement run
+ * many times is a parse storm, the client does not cache statements.
+ */
+enum {
+	TNS_PARSE_STAT_COL_SESSION = 0,
+	TNS_PARSE_STAT_COL_SQL,
+	TNS_PARSE_STAT_COL_PARSES,
+	TNS_PARSE_STAT_COL_EXECUTES,
+	TNS_PARSE_STAT_COL_RATIO
+};
+
+static stat_tap_table_item tns_parse_stat_fields[] = {
+	{TABLE_ITEM_STRING, TAP_ALIGN_LEFT,  "Session", "%-24s"},
+	{TABLE_ITEM_STRING, TAP_ALIGN_LEFT,  "SQL Statement", "%-60s"},
+	{TABLE_ITEM_UINT,   TAP_ALIGN_RIGHT, "Parse Calls", "%u"},
+	{TABLE_ITEM_UINT,   TAP_ALIGN_RIGHT, "Cursor Executes", "%u"},
+	{TABLE_ITEM_FLOAT,  TAP_ALIGN_RIGHT, "Parses (%)", "%.1f"}
+};
+
+/* rows keyed by "conversation index/statement fingerprint" */
+static void tns_parse_stat_init(stat_tap_table_ui* new_stat)
+{
+	tns_stat_init(new_stat, "TNS Parses");
+}
+
+static tap_packet_status tns_parse_stat_packet(void *tapdata, packet_info *pinfo _U_, epan_dissect_t *edt _U_, const void *data, tap_flags_t flags _U_)
+{
+	stat_data_t *stat_data = (stat_data_t *) tapdata;
+	const tns_sql_tap_info_t *tap_info = (const tns_sql_tap_info_t *) data;
+	stat_tap_table *table;
+	stat_tap_table_item_type *item;
+	tns_stat_row_t *stat_row;
+	gchar *key;
+	guint row, parses, executes;
+
+	if ( tap_info->is_response || tap_info->oci_func_id != SQLNET_USER_FUNC_OALL8 )
+	{
+		return TAP_PACKET_DONT_REDRAW;
+	}
+
+	table = g_array_index(stat_data->stat_tap_data->tables, stat_tap_table*, 0);
+
+	key = g_strdup_printf("%u/%016" PRIx64, tap_info->conv_index, tap_info->fingerprint);
+	stat_row = tns_stat_lookup(table, key);
+	if ( stat_row )
+	{
+		g_free(key);
+	}
+	else
+	{
+		stat_tap_table_item_type items[array_length(tns_parse_stat_fields)];
+
+		memset(items, 0, sizeof(items));
+
+		/* the conversation, with the user and session id if known */
+		if ( tap_info->session_user && tap_info->session_sid )
+			items[TNS_PARSE_STAT_COL_SESSION].value.string_value = g_strdup_printf("%u %s SID %s",
+				tap_info->conv_index, tap_info->session_user, tap_info->session_sid);
+		else if ( tap_info->session_user )
+			items[TNS_PARSE_STAT_COL_SESSION].value.string_value = g_strdup_printf("%u %s",
+				tap_info->conv_index, tap_info->session_user);
+		else
+			items[TNS_PARSE_STAT_COL_SESSION].value.string_value = g_strdup_printf("%u",
+				tap_info->conv_index);
+		items[TNS_PARSE_STAT_COL_SQL].value.string_value = g_strdup(tap_info->sql);
+		stat_row = tns_stat_add(stat_data, table, key, g_str_hash, g_str_equal, sizeof(tns_stat_row_t), items);
+	}
+	row = stat_row->row;
+
+	item = stat_tap_get_field_data(table, row, TNS_PARSE_STAT_COL_PARSES);
+	if ( tap_info->parse )
+	{
+		item->value.uint_value++;
+		stat_tap_set_field_data(table, row, TNS_PARSE_STAT_COL_PARSES, item);
+	}
+	parses = item->value.uint_value;
+
+	item = stat_tap_get_field_data(table, row, TNS_PARSE_STAT_COL_EXECUTES);
+	if ( !tap_info->parse )
+	{
+		item->value.uint_value++;
+		stat_tap_set_field_data(table, row, TNS_PARSE_STAT_COL_EXECUTES, item);
+	}
+	executes = item->value.uint_value;
+
+	item = stat_tap_get_field_data(table, row, TNS_PARSE_STAT_COL_RATIO);
+	item->value.float_value = 100.0 * parses / (parses + executes);
+	stat_tap_set_field_data(table, row, TNS_PARSE_STAT_COL_RATIO, item);
+
+	return TAP_PACKET_REDRAW;
+}
+
+static void tns_parse_stat_reset(stat_tap_table* table)
+{
+	tns_stat_reset(table, TNS_PARSE_STAT_COL_PARSES);
+}
+
+static void tns_parse_stat_free_table_item(stat_tap_table* table _U_, guint row _U_, guint column, stat_tap_table_item_type* field_data)
+{
+	if ( column == TNS_PARSE_STAT_COL_SESSION || column == TNS_PARSE_STAT_COL_SQL )
+	{
+		g_free((char *) field_data->value.string_value);
+	}
+	tns_stat_free_item(column, field_data, NULL);
+}
+
+static tap_param tns_parse_stat_params[] = {
+	{ PARAM_FILTER, "filter", "Filter", NULL, TRUE }
+};
+
+static stat_tap_table_ui tns_parse_stat_table = {
+	REGISTER_PACKET_STAT_GROUP_UNSORTED,
+	"TNS/Parses",
+	"tns",
+	"tns,parse",
+	tns_parse_stat_init,
+	tns_parse_stat_packet,
+	tns_parse_stat_reset,
+	tns_parse_stat_free_table_item,
+	NULL,
+	array_length(tns_parse_stat_fields), tns_parse_stat_fields,
+	array_length(tns_parse_stat_params), tns_parse_stat_params,
+	NULL,
+	0
+};
+
+/*
+ * TTC marshals integers (ub2, ub4, ub8, sb8) in a compressed form: a
+ * length byte followed by that many big endian value bytes, bit 0x80 of
+ * the length byte marks a negative signed value. The unsigned readers
+ * reject it. Returns the number of
+ * bytes used, or 0 if the value is malformed, longer than max_len or not
+ * captured.
+ */
+static int tns_get_ttc_int(tvbuff_t *tvb, int offset, guint max_len, guint64 *value, gboolean *negative)
+{
+	guint8 len;
+
+	if ( !tvb_bytes_exist(tvb, offset, 1) )
+		return 0;
+
+	len = tvb_get_guint8(tvb, offset);
+	*negative = (len & 0x80) != 0;
+	len &= 0x7f;
+
+	/* the common short forms first */
+	switch (len)
+	{
+		case 0:
+			*value = 0;
+			return 1;
+		case 1:
+			if ( !tvb_bytes_exist(tvb, offset + 1, 1) )
+				return 0;
+			*value = tvb_get_guint8(tvb, offset + 1);
+			return 2;
+		case 2:
+			if ( max_len < 2 || !tvb_bytes_exist(tvb, offset + 1, 2) )
+				return 0;
+			*value = tvb_get_ntohs(tvb, offset + 1);
+			return 3;
+	}
+
+	if ( len > max_len || !tvb_bytes_exist(tvb, offset + 1, len) )
+		return 0;
+
+	*value = 0;
+	for (int i = 1; i <= len; i++)
+		*value = (*value << 8) | tvb_get_guint8(tvb, offset + i);
+
+	return 1 + len;
+}
+
+static int tns_get_ttc_ub2(tvbuff_t *tvb, int offset, guint32 *value)
+{
+	guint64 v;
+	gboolean negative;
+	int len;
+
+	len = tns_get_ttc_int(tvb, offset, 2, &v, &negative);
+	if ( len == 0 || negative )
+		return 0;
+
+	*value = (guint32) v;
+	return len;
+}
+
+static int tns_get_ttc_ub4(tvbuff_t *tvb, int offset, guint32 *value)
+{
+	guint64 v;
+	gboolean negative;
+	int len;
+
+	len = tns_get_ttc_int(tvb, offset, 4, &v, &negative);
+	if ( len == 0 || negative )
+		return 0;
+
+	*value = (guint32) v;
+	return len;
+}
+
+static int tns_get_ttc_ub8(tvbuff_t *tvb, int offset, guint64 *value)
+{
+	gboolean negative;
+	int len;
+
+	len = tns_get_ttc_int(tvb, offset, 8, value, &negative);
+	if ( negative )
+		return 0;
+
+	return len;
+}
+
+/*
+ * Pointers are sent as a single byte, 0 for NULL. Only the presence of
+ * the referenced value is known, it follows later in the message.
+ */
+static int tns_get_ttc_ptr(tvbuff_t *tvb, int offset, gboolean *present)
+{
+	if ( !tvb_bytes_exist(tvb, offset, 1) )
+		return 0;
+
+	*present = tvb_get_guint8(tvb, offset) != 0;
+	return 1;
+}
+
+/* Length byte announcing a value sent in chunks */
+#define TTCI_LONG_LENGTH_MARKER 0xfe
+
+/* TTC field versions: 12.1 has ub4 chunk lengths, later ones extend
+ * the OALL8 header and add a token to the calls */
+#define TTC_FIELD_VERSION_12_1       7
+#define TTC_FIELD_VERSION_12_2       8
+#define TTC_FIELD_VERSION_12_2_EXT1  9
+#define TTC_FIELD_VERSION_23_1_EXT1  18
+
+/*
+ * Values longer than 252 bytes (long VARCHAR2, RAW, PL/SQL blocks) are
+ * sent in chunks: the 0xfe marker, then length prefixed chunks up to a
+ * chunk of length 0. The chunk lengths are compressed ub4 from TTC field
+ * version 12.1 on, which is also assumed if the version is not known,
+ * and single bytes before.
+ *
+ * Walks the chunks behind the marker at offset. Returns the offset behind
+ * the terminating chunk and the logical value length, or -1 if the value
+ * is empty or not complete. Each chunk is visited once; if composite is
+ * not NULL, the chunks are appended to it as subsets of tvb, so the value
+ * is presented without copying.
+ */
+static int tns_walk_chunks(tvbuff_t *tvb, int offset, guint8 ttc_field_version, guint32 *value_length, tvbuff_t *composite)
+{
+	gboolean ub4_lengths;
+	guint32 chunk_len, total = 0;
+	int len;
+
+	ub4_lengths = ttc_field_version == 0 || ttc_field_version >= TTC_FIELD_VERSION_12_1;
+
+	offset += 1;
+	for (;;)
+	{
+		if ( ub4_lengths )
+		{
+			len = tns_get_ttc_ub4(tvb, offset, &chunk_len);
+			if ( len == 0 )
+				return -1;
+		}
+		else
+		{
+			if ( !tvb_bytes_exist(tvb, offset, 1) )
+				return -1;
+			chunk_len = tvb_get_guint8(tvb, offset);
+			len = 1;
+		}
+		offset += len;
+
+		if ( chunk_len == 0 )
+			break;
+
+		if ( !tvb_bytes_exist(tvb, offset, chunk_len) || total + chunk_len < total )
+			return -1;
+
+		if ( composite )
+			tvb_composite_append(composite, tvb_new_subset_length(tvb, offset, chunk_len));
+
+		total += chunk_len;
+		offset += chunk_len;
+	}
+
+	if ( total == 0 )
+		return -1;
+
+	*value_length = total;
+	return offset;
+}
+
+/*
+ * Logical value of a chunked value, as a composite of its chunks. It is
+ * shown as a data source if name is given, else only chained to tvb.
+ */
+static tvbuff_t *tns_chunked_value_tvb(tvbuff_t *tvb, packet_info *pinfo, int offset, guint8 ttc_field_version, const char *name)
+{
+	tvbuff_t *composite;
+	guint32 length;
+
+	composite = tvb_new_composite();
+	tns_walk_chunks(tvb, offset, ttc_field_version, &length, composite);
+	tvb_composite_finalize(composite);
+	if ( name )
+		add_new_data_source(pinfo, composite, name);
+	else
+		tvb_add_to_chain(tvb, composite);
+
+	return composite;
+}
+
+/* FNV-1a, 64 bit */
+#define TNS_FNV1A_64_BASIS G_GUINT64_CONSTANT(0xcbf29ce484222325)
+#define TNS_FNV1A_64_PRIME G_GUINT64_CONSTANT(0x100000001b3)
+
+/* First keywords of the statements, as found in the normalized text */
+static const gchar *const tns_sql_verbs[] = {
+	"SELECT", "INSERT", "UPDATE", "DELETE", "MERGE", "WITH",
+	"BEGIN", "DECLARE", "CALL", "LOCK", "EXPLAIN", "SET",
+	"COMMIT", "ROLLBACK", "SAVEPOINT",
+	"CREATE", "ALTER", "DROP", "TRUNCATE", "RENAME", "COMMENT",
+	"GRANT", "REVOKE", "ANALYZE", "AUDIT", "NOAUDIT", "PURGE", "FLASHBACK",
+	NULL
+};
+
+/* Normalized text being written, hashed as it grows */
+typedef struct {
+	gchar *text;
+	gsize len;
+	guint64 hash;
+} tns_sql_norm_t;
+
+static inline void tns_sql_norm_put(tns_sql_norm_t *norm, gchar c)
+{
+	norm->text[norm->len++] = c;
+	norm->hash = (norm->hash ^ (guint8) c) * TNS_FNV1A_64_PRIME;
+}
+
+#define TNS_SQL_IDENT_CHAR(c) (g_ascii_isalnum(c) || (c) == '_' || (c) == '$' || (c) == '#' || ((c) & 0x80))
+
+/* Token classes of the normalized text, they decide about the blanks */
+typedef enum {
+	TNS_SQL_TOKEN_NONE,        /* start of the text */
+	TNS_SQL_TOKEN_WORD,        /* keyword, identifier, bind variable or literal */
+	TNS_SQL_TOKEN_OPERATOR,
+	TNS_SQL_TOKEN_OPEN,        /* ( [ */
+	TNS_SQL_TOKEN_CLOSE,       /* ) ] */
+	TNS_SQL_TOKEN_COMMA,
+	TNS_SQL_TOKEN_JOIN,        /* . @ %, as in schema.table@link or col%TYPE */
+	TNS_SQL_TOKEN_SEMICOLON
+} tns_sql_token_t;
+
+/* Operators of two characters, a single token each */
+static const gchar *const tns_sql_operators[] = {
+	"<=", ">=", "<>", "!=", "^=", "~=", "||", ":=", "=>", "**", "<<", ">>",
+	NULL
+};
+
+static tns_sql_token_t tns_sql_char_token(gchar c)
+{
+	switch (c)
+	{
+		case '(': case '[': return TNS_SQL_TOKEN_OPEN;
+		case ')': case ']': return TNS_SQL_TOKEN_CLOSE;
+		case ',':           return TNS_SQL_TOKEN_COMMA;
+		case '.': case '@':
+		case '%':           return TNS_SQL_TOKEN_JOIN;
+		case ';':           return TNS_SQL_TOKEN_SEMICOLON;
+		default:            return TNS_SQL_TOKEN_OPERATOR;
+	}
+}
+
+/* End of the operator at sql[i] */
+static gsize tns_sql_operator_end(const gchar *sql, gsize i, gsize n)
+{
+	if ( i + 1 < n )
+	{
+		for (int k = 0; tns_sql_operators[k]; k++)
+		{
+			if ( sql[i] == tns_sql_operators[k][0] && sql[i + 1] == tns_sql_operators[k][1] )
+				return i + 2;
+		}
+	}
+	return i + 1;
+}
+
+/*
+ * Blank between the last token written and the next one, by their
+ * classes only, whatever the text had: none after an opening parenthesis,
+ * none before a closing one, a comma or a semicolon, none around a dot
+ * and none between a word and the parenthesis that follows it.
+ */
+static gboolean tns_sql_norm_blank(tns_sql_token_t last, tns_sql_token_t next)
+{
+	switch (last)
+	{
+		case TNS_SQL_TOKEN_NONE:
+		case TNS_SQL_TOKEN_OPEN:
+		case TNS_SQL_TOKEN_JOIN:
+			return FALSE;
+		default:
+			break;
+	}
+
+	switch (next)
+	{
+		case TNS_SQL_TOKEN_OPEN:
+			return last != TNS_SQL_TOKEN_WORD;
+		case TNS_SQL_TOKEN_CLOSE:
+		case TNS_SQL_TOKEN_COMMA:
+		case TNS_SQL_TOKEN_JOIN:
+		case TNS_SQL_TOKEN_SEMICOLON:
+			return FALSE;
+		default:
+			return TRUE;
+	}
+}
+
+/*
+ * End of the literal at sql[i], or i if there is none: a string, also
+ * national (N'..') or with alternative quotes (Q'[..]'), or a number.
+ * An unterminated literal runs to the end of the text.
+ */
+static gsize tns_sql_literal_end(const gchar *sql, gsize i, gsize n)
+{
+	gsize j = i;
+	gchar c = sql[j];
+
+	if ( c == 'n' || c == 'N' )
+	{
+		if ( j + 1 < n && (sql[j + 1] == '\'' || sql[j + 1] == 'q' || sql[j + 1] == 'Q') )
+			c = sql[++j];
+		else
+			return i;
+	}
+
+	if ( (c == 'q' || c == 'Q') && j + 2 < n && sql[j + 1] == '\'' )
+	{
+		gchar close = sql[j + 2];
+
+		switch (close)
+		{
+			case '[': close = ']'; break;
+			case '{': close = '}'; break;
+			case '<': close = '>'; break;
+			case '(': close = ')'; break;
+		}
+		for (j += 3; j < n; j++)
+		{
+			if ( sql[j] == close && j + 1 < n && sql[j + 1] == '\'' )
+				return j + 2;
+		}
+		return n;
+	}
+
+	if ( c == '\'' )
+	{
+		for (j++; j < n; j++)
+		{
+			if ( sql[j] != '\'' )
+				continue;
+			if ( j + 1 < n && sql[j + 1] == '\'' )
+				j++;
+			else
+				return j + 1;
+		}
+		return n;
+	}
+
+	if ( j != i )
+		return i;
+
+	if ( g_ascii_isdigit(c) || (c == '.' && j + 1 < n && g_ascii_isdigit(sql[j + 1])) )
+	{
+		while ( j < n && g_ascii_isdigit(sql[j]) )
+			j++;
+		if ( j < n && sql[j] == '.' )
+			j++;
+		while ( j < n && g_ascii_isdigit(sql[j]) )
+			j++;
+		if ( j < n && (sql[j] == 'e' || sql[j] == 'E') )
+		{
+			gsize k = j + 1;
+
+			if ( k < n && (sql[k] == '+' || sql[k] == '-') )
+				k++;
+			if ( k < n && g_ascii_isdigit(sql[k]) )
+			{
+				j = k;
+				while ( j < n && g_ascii_isdigit(sql[j]) )
+					j++;
+			}
+		}
+		/* BINARY_FLOAT and BINARY_DOUBLE suffixes */
+		if ( j < n && (sql[j] == 'f' || sql[j] == 'F' || sql[j] == 'd' || sql[j] == 'D') &&
+		     !(j + 1 < n && TNS_SQL_IDENT_CHAR(sql[j + 1])) )
+			j++;
+		return j;
+	}
+
+	return i;
+}
+
+/*
+ * Normalize a statement in a single pass, without backtracking: comments
+ * are dropped, tokens are separated by single blanks (see
+ * tns_sql_norm_blank()), unquoted words are upper cased, string and
+ * number literals become '?' and so does a list of them in the
+ * parentheses of IN. Bind variables and quoted identifiers are kept, a
+ * sign is an operator of its own. The fingerprint is the FNV-1a hash of
+ * the normalized text, the verb the first word of it if it starts a
+ * statement.
+ */
+static gchar *tns_sql_normalize(wmem_allocator_t *scope, const gchar *sql, guint64 *fingerprint, const gchar **verb)
+{
+	tns_sql_norm_t norm;
+	gsize i = 0, n = strlen(sql);
+	tns_sql_token_t last = TNS_SQL_TOKEN_NONE;
+	gboolean comma = FALSE;        /* comma pending behind a literal of an IN list */
+	gboolean after_in = FALSE;     /* last token was the word IN */
+	gboolean literal = FALSE;      /* last token was a literal */
+	gint depth = 0, in_depth = -1; /* parentheses, of the innermost IN list */
+
+	/* every token is at least a character of the text, and gets at
+	 * most one blank in front */
+	norm.text = (gchar *) wmem_alloc(scope, 2 * n + 1);
+	norm.len = 0;
+	norm.hash = TNS_FNV1A_64_BASIS;
+	*verb = NULL;
+
+	while ( i < n )
+	{
+		gchar c = sql[i];
+		gboolean bind;
+		tns_sql_token_t token;
+		gsize end;
+
+		if ( g_ascii_isspace(c) )
+		{
+			i++;
+			continue;
+		}
+		if ( c == '-' && i + 1 < n && sql[i + 1] == '-' )
+		{
+			while ( i < n && sql[i] != '\n' )
+				i++;
+			continue;
+		}
+		if ( c == '/' && i + 1 < n && sql[i + 1] == '*' )
+		{
+			for (i += 2; i < n && !(sql[i] == '*' && i + 1 < n && sql[i + 1] == '/'); i++)
+				;
+			i = MIN(i + 2, n);
+			continue;
+		}
+
+		end = tns_sql_literal_end(sql, i, n);
+
+		/* another literal of the list of IN merges into the first one */
+		if ( comma )
+		{
+			comma = FALSE;
+			if ( end > i )
+			{
+				i = end;
+				continue;
+			}
+			tns_sql_norm_put(&norm, ',');
+			last = TNS_SQL_TOKEN_COMMA;
+		}
+
+		bind = c == ':' && i + 1 < n && TNS_SQL_IDENT_CHAR(sql[i + 1]);
+		if ( end > i || bind || c == '"' || TNS_SQL_IDENT_CHAR(c) )
+			token = TNS_SQL_TOKEN_WORD;
+		else
+			token = tns_sql_char_token(c);
+
+		if ( token == TNS_SQL_TOKEN_COMMA && literal && depth == in_depth )
+		{
+			i++;
+			comma = TRUE;
+			continue;
+		}
+
+		if ( tns_sql_norm_blank(last, token) )
+			tns_sql_norm_put(&norm, ' ');
+		last = token;
+
+		if ( end > i )
+		{
+			tns_sql_norm_put(&norm, '?');
+			i = end;
+			after_in = FALSE;
+			literal = TRUE;
+			continue;
+		}
+
+		if ( TNS_SQL_IDENT_CHAR(c) )
+		{
+			gsize start = norm.len;
+
+			for (; i < n && TNS_SQL_IDENT_CHAR(sql[i]); i++)
+				tns_sql_norm_put(&norm, g_ascii_toupper(sql[i]));
+
+			after_in = norm.len - start == 2 && norm.text[start] == 'I' && norm.text[start + 1] == 'N';
+			if ( start == 0 || (norm.text[start - 1] == '(' && *verb == NULL) )
+			{
+				for (int v = 0; tns_sql_verbs[v] && *verb == NULL; v++)
+				{
+					if ( strlen(tns_sql_verbs[v]) == norm.len - start &&
+					     strncmp(tns_sql_verbs[v], norm.text + start, norm.len - start) == 0 )
+						*verb = tns_sql_verbs[v];
+				}
+			}
+		}
+		else if ( c == '"' )
+		{
+			/* quoted identifier, as is */
+			do
+				tns_sql_norm_put(&norm, sql[i++]);
+			while ( i < n && sql[i] != '"' );
+			if ( i < n )
+				tns_sql_norm_put(&norm, sql[i++]);
+			after_in = FALSE;
+		}
+		else if ( bind )
+		{
+			/* bind variable, by name or position */
+			tns_sql_norm_put(&norm, sql[i++]);
+			for (; i < n && TNS_SQL_IDENT_CHAR(sql[i]); i++)
+				tns_sql_norm_put(&norm, g_ascii_toupper(sql[i]));
+			after_in = FALSE;
+		}
+		else if ( token == TNS_SQL_TOKEN_OPERATOR )
+		{
+			for (end = tns_sql_operator_end(sql, i, n); i < end; i++)
+				tns_sql_norm_put(&norm, sql[i]);
+			after_in = FALSE;
+		}
+		else
+		{
+			i++;
+			tns_sql_norm_put(&norm, c);
+			if ( c == '(' )
+			{
+				depth++;
+				if ( after_in )
+					in_depth = depth;
+			}
+			else if ( c == ')' )
+			{
+				if ( depth == in_depth )
+					in_depth = -1;
+				depth--;
+			}
+			after_in = FALSE;
+		}
+		literal = FALSE;
+	}
+
+	if ( comma )
+		tns_sql_norm_put(&norm, ',');
+
+	norm.text[norm.len] = '\0';
+	*fingerprint = norm.hash;
+	return norm.text;
+}
+
+/*
+ * Single copy of a statement text, shared by all cursors and frames.
+ * Statements are added on the first pass only, later passes look them up
+ * and get one in the packet scope if it is not there. The normalized text
+ * is built in the packet scope and kept at its length.
+ */
+static const tns_sql_t *tns_intern_sql(packet_info *pinfo, const gchar *sql)
+{
+	tns_sql_t *statement;
+	gchar *normalized;
+
+	statement = (tns_sql_t *) wmem_map_lookup(tns_sql_texts, sql);
+	if ( statement )
+	{
+		return statement;
+	}
+
+	if ( PINFO_FD_VISITED(pinfo) )
+	{
+		statement = wmem_new(pinfo->pool, tns_sql_t);
+		statement->text = sql;
+		statement->normalized = tns_sql_normalize(pinfo->pool, sql, &statement->fingerprint, &statement->verb);
+		return statement;
+	}
+
+	statement = wmem_new(wmem_file_scope(), tns_sql_t);
+	statement->text = wmem_strdup(wmem_file_scope(), sql);
+	normalized = tns_sql_normalize(pinfo->pool, sql, &statement->fingerprint, &statement->verb);
+	statement->normalized = wmem_strdup(wmem_file_scope(), normalized);
+	wmem_free(pinfo->pool, normalized);
+	wmem_map_insert(tns_sql_texts, (gpointer) statement->text, statement);
+
+	return statement;
+}
+
+static void tns_cursor_unlink(tns_conv_info_t *tns_info, tns_cursor_t *cursor)
+{
+	if ( cursor->prev )
+		cursor->prev->next = cursor->next;
+	else
+		tns_info->cursor_mru = cursor->next;
+
+	if ( cursor->next )
+		cursor->next->prev = cursor->prev;
+	else
+		tns_info->cursor_lru = cursor->prev;
+
+	cursor->prev = cursor->next = NULL;
+}
+
+static void tns_cursor_link_mru(tns_conv_info_t *tns_info, tns_cursor_t *cursor)
+{
+	cursor->prev = NULL;
+	cursor->next = tns_info->cursor_mru;
+	if ( tns_info->cursor_mru )
+		tns_info->cursor_mru->prev = cursor;
+	else
+		tns_info->cursor_lru = cursor;
+	tns_info->cursor_mru = cursor;
+}
+
+static void tns_cursor_close(tns_conv_info_t *tns_info, guint32 cursor_id)
+{
+	tns_cursor_t *cursor;
+
+	cursor = (tns_cursor_t *) wmem_map_remove(tns_info->cursors, GUINT_TO_POINTER(cursor_id));
+	if ( cursor )
+	{
+		tns_cursor_unlink(tns_info, cursor);
+		wmem_free(wmem_file_scope(), cursor);
+	}
+}
+
+/* Cursor of the conversation, marked as most recently used (first pass only) */
+static tns_cursor_t *tns_cursor_lookup(tns_conv_info_t *tns_info, guint32 cursor_id)
+{
+	tns_cursor_t *cursor;
+
+	cursor = (tns_cursor_t *) wmem_map_lookup(tns_info->cursors, GUINT_TO_POINTER(cursor_id));
+	if ( cursor && cursor != tns_info->cursor_mru )
+	{
+		tns_cursor_unlink(tns_info, cursor);
+		tns_cursor_link_mru(tns_info, cursor);
+	}
+
+	return cursor;
+}
+
+/* Remember the statement of a cursor, evicting the least recently used
+ * one if the table of the conversation is full (first pass only) */
+static void tns_cursor_open(tns_conv_info_t *tns_info, guint32 cursor_id, const gchar *sql, guint32 frame)
+{
+	tns_cursor_t *cursor;
+
+	cursor = tns_cursor_lookup(tns_info, cursor_id);
+	if ( !cursor )
+	{
+		while ( tns_info->cursor_lru && wmem_map_size(tns_info->cursors) >= MAX(tns_cursor_cache_size, 1) )
+		{
+			tns_cursor_close(tns_info, tns_info->cursor_lru->cursor_id);
+		}
+
+		cursor = wmem_new0(wmem_file_scope(), tns_cursor_t);
+		cursor->cursor_id = cursor_id;
+		cursor->fetch_sizes = wmem_tree_new(wmem_file_scope());
+		wmem_map_insert(tns_info->cursors, GUINT_TO_POINTER(cursor_id), cursor);
+		tns_cursor_link_mru(tns_info, cursor);
+	}
+
+	if ( cursor->sql != sql )
+	{
+		cursor->columns = 0;
+		cursor->fetches = 0;
+		cursor->rows = 0;
+		if ( cursor->fetch_samples > 0 )
+		{
+			cursor->fetch_sizes = wmem_tree_new(wmem_file_scope());
+		}
+		cursor->fetch_samples = 0;
+		cursor->fetch_reported = FALSE;
+	}
+	cursor->sql = sql;
+	cursor->parse_frame = frame;
+}
+
+/*
+ * Add the cursor id with the statement it was parsed for. The statement
+ * is resolved on the first pass and kept with the frame, per item as a
+ * PDU may reference several cursors. Later passes show the same even if
+ * the cursor has been closed or reused meanwhile.
+ *
+ * Returns the statement, NULL if the cursor is not known.
+ */
+static const gchar *tns_cursor_add_item(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, int offset, int length,
+				tns_conv_info_t *tns_info, guint32 cursor_id)
+{
+	tns_pdu_info_t *pdu_info;
+	tns_cursor_ref_t *ref = NULL;
+	proto_item *pi;
+
+	pdu_info = tns_get_pdu_info(pinfo);
+	if ( !PINFO_FD_VISITED(pinfo) )
+	{
+		tns_cursor_t *cursor = tns_cursor_lookup(tns_info, cursor_id);
+
+		if ( cursor )
+		{
+			if ( !pdu_info->cursors )
+			{
+				pdu_info->cursors = wmem_map_new(wmem_file_scope(), g_direct_hash, g_direct_equal);
+			}
+			ref = wmem_new(wmem_file_scope(), tns_cursor_ref_t);
+			ref->sql = cursor->sql;
+			ref->parse_frame = cursor->parse_frame;
+			wmem_map_insert(pdu_info->cursors, GINT_TO_POINTER(offset), ref);
+		}
+	}
+	else if ( pdu_info->cursors )
+	{
+		ref = (tns_cursor_ref_t *) wmem_map_lookup(pdu_info->cursors, GINT_TO_POINTER(offset));
+	}
+
+	proto_tree_add_uint(tree, hf_tns_data_cursor_id, tvb, offset, length, cursor_id);
+
+	if ( !ref )
+	{
+		return NULL;
+	}
+
+	pi = proto_tree_add_string(tree, hf_tns_data_cursor_sql, tvb, offset, length, ref->sql);
+	proto_item_set_generated(pi);
+	pi = proto_tree_add_uint(tree, hf_tns_data_cursor_parse_frame, tvb, 0, 0, ref->parse_frame);
+	proto_item_set_generated(pi);
+
+	return ref->sql;
+}
+
+/*
+ * A statement parsed into a new cursor (id 0) gets its id from the server.
+ * It is found in the RPA (al8o4[2]) or in the Return Status message that
+ * opens the response.
+ */
+static void tns_cursor_response(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, int offset,
+				tns_conv_info_t *tns_info, guint data_func_id)
+{
+	guint32 value, cursor_id = 0;
+	int cursor_offset = -1, len = 0;
+
+	if ( data_func_id == SQLNET_RETURN_OPI_PARAM )
+	{
+		guint32 count;
+
+		/* ub2 element count, then the ub4 elements */
+		len = tns_get_ttc_ub2(tvb, offset, &count);
+		if ( len == 0 || count < 3 )
+			return;
+		offset += len;
+
+		for (guint32 i = 0; i <= 2; i++)
+		{
+			len = tns_get_ttc_ub4(tvb, offset, &value);
+			if ( len == 0 )
+				return;
+			cursor_offset = offset;
+			offset += len;
+		}
+		cursor_id = value;
+	}
+	else if ( data_func_id == SQLNET_RETURN_STATUS )
+	{
+		/* end of call status (ub4) and ECID sequence (ub2) from TTC
+		 * version 3 on, then current row (ub4), return code, array
+		 * element with error, array element errno (ub2) and cursor (ub2) */
+		int skip = tns_info->ttc_version >= 3 ? 6 : 4;
+
+		for (int i = 0; i <= skip; i++)
+		{
+			len = tns_get_ttc_ub4(tvb, offset, &value);
+			if ( len == 0 )
+				return;
+			cursor_offset = offset;
+			offset += len;
+		}
+		cursor_id = value;
+	}
+
+	if ( cursor_offset < 0 )
+		return;
+
+	if ( !PINFO_FD_VISITED(pinfo) && tns_info->pending_sql && cursor_id != 0 )
+	{
+		tns_cursor_open(tns_info, cursor_id, tns_info->pending_sql, tns_info->pending_frame);
+	}
+
+	tns_cursor_add_item(tvb, pinfo, tree, cursor_offset, len, tns_info, cursor_id);
+}
+
+/*
+ * Authentication keys of the session identity. The user name is sent in
+ * the header of the client's authentication calls, program, machine and
+ * terminal as parameters of the calls and session id and serial number
+ * as parameters of the server's response to the second call.
+ */
+static const struct {
+	const gchar *key;       /* NULL if not a parameter */
+	int *hf;
+	gboolean numeric;
+} tns_session_keys[TNS_SESSION_COUNT] = {
+	[TNS_SESSION_USER]     = { NULL,              &hf_tns_session_user,     FALSE },
+	[TNS_SESSION_SID]      = { "AUTH_SESSION_ID", &hf_tns_session_sid,      TRUE },
+	[TNS_SESSION_SERIAL]   = { "AUTH_SERIAL_NUM", &hf_tns_session_serial,   TRUE },
+	[TNS_SESSION_PROGRAM]  = { "AUTH_PROGRAM_NM", &hf_tns_session_program,  FALSE },
+	[TNS_SESSION_MACHINE]  = { "AUTH_MACHINE",    &hf_tns_session_machine,  FALSE },
+	[TNS_SESSION_TERMINAL] = { "AUTH_TERMINAL",   &hf_tns_session_terminal, FALSE },
+};
+
+/*
+ * Change a value of the session identity, first pass only. The values
+ * apply from the next frame on, a session reauthenticated on the same
+ * connection keeps its former identity on the earlier frames.
+ */
+static void tns_session_set(packet_info *pinfo, tns_conv_info_t *tns_info, int index, const gchar *value)
+{
+	const gchar **values;
+
+	values = (const gchar **) wmem_tree_lookup32(tns_info->sessions, pinfo->num + 1);
+	if ( !values )
+	{
+		const gchar *const *last = tns_session_values(pinfo, tns_info);
+
+		values = wmem_alloc0_array(wmem_file_scope(), const gchar *, TNS_SESSION_COUNT);
+		if ( last )
+		{
+			memcpy(values, last, TNS_SESSION_COUNT * sizeof(*values));
+		}
+		wmem_tree_insert32(tns_info->sessions, pinfo->num + 1, values);
+	}
+	values[index] = value;
+}
+
+/* Keep an authentication parameter of the session identity, first pass only */
+static void tns_session_set_param(packet_info *pinfo, tns_conv_info_t *tns_info, tvbuff_t *tvb,
+				  int name_offset, int name_len, int value_offset, int value_len)
+{
+	if ( PINFO_FD_VISITED(pinfo) || name_len <= 0 || value_len <= 0 )
+		return;
+
+	for (int i = 0; i < TNS_SESSION_COUNT; i++)
+	{
+		const gchar *key = tns_session_keys[i].key;
+
+		if ( key && (size_t) name_len == strlen(key) &&
+		     tvb_strneql(tvb, name_offset, key, name_len) == 0 )
+		{
+			tns_session_set(pinfo, tns_info, i, (const gchar *) tvb_get_string_enc(wmem_file_scope(), tvb,
+				value_offset, value_len, ENC_ASCII));
+			return;
+		}
+	}
+}
+
+/*
+ * Byte string with a ub1 length, or chunked. Returns the bytes used and
+ * the location of the value, *value_offset is -1 for a chunked value.
+ */
+static int tns_get_ttc_bytes(tvbuff_t *tvb, int offset, guint8 ttc_field_version, int *value_offset, guint32 *value_len)
+{
+	guint8 len;
+	int end;
+
+	if ( !tvb_bytes_exist(tvb, offset, 1) )
+		return 0;
+
+	len = tvb_get_guint8(tvb, offset);
+	if ( len == TTCI_LONG_LENGTH_MARKER )
+	{
+		end = tns_walk_chunks(tvb, offset, ttc_field_version, value_len, NULL);
+		if ( end < 0 )
+			return 0;
+		*value_offset = -1;
+		return end - offset;
+	}
+
+	if ( !tvb_bytes_exist(tvb, offset + 1, len) )
+		return 0;
+
+	*value_offset = offset + 1;
+	*value_len = len;
+	return 1 + len;
+}
+
+/* Length byte of a NULL column value, a zero length is NULL as well */
+#define TTCI_NULL_LENGTH 0xff
+
+/* Oracle error code ending a fetch */
+#define TNS_ORA_NO_DATA_FOUND 1403
+
+/* First TTC field version with the domain of a column in the describe */
+#define TTC_FIELD_VERSION_23_1 17
+
+/*
+ * Oracle data types whose row values are sent as a plain length prefixed
+ * (or chunked) byte string. Others (LONG, LOBs, ROWIDs, cursors, objects,
+ * JSON, vectors) carry more than the value and stop the row count.
+ */
+static gboolean tns_plain_column_type(guint8 type)
+{
+	switch (type)
+	{
+		case 1:         /* VARCHAR2 */
+		case 2:         /* NUMBER */
+		case 12:        /* DATE */
+		case 23:        /* RAW */
+		case 96:        /* CHAR */
+		case 100:       /* BINARY_FLOAT */
+		case 101:       /* BINARY_DOUBLE */
+		case 180:       /* TIMESTAMP */
+		case 181:       /* TIMESTAMP WITH TIME ZONE */
+		case 182:       /* INTERVAL YEAR TO MONTH */
+		case 183:       /* INTERVAL DAY TO SECOND */
+		case 231:       /* TIMESTAMP WITH LOCAL TIME ZONE */
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
+/* Column value of a row. Returns the bytes used, 0 if not captured. */
+static int tns_skip_ttc_value(tvbuff_t *tvb, int offset, guint8 ttc_field_version)
+{
+	int value_offset;
+	guint32 value_len;
+
+	if ( !tvb_bytes_exist(tvb, offset, 1) )
+		return 0;
+
+	if ( tvb_get_guint8(tvb, offset) == TTCI_NULL_LENGTH )
+		return 1;
+
+	return tns_get_ttc_bytes(tvb, offset, ttc_field_version, &value_offset, &value_len);
+}
+
+/* Optional string of the describe: ub4 length, then the string if not empty */
+static int tns_skip_ttc_string(tvbuff_t *tvb, int offset, guint8 ttc_field_version)
+{
+	guint32 value_len;
+	int value_offset, len, str_len = 0;
+
+	len = tns_get_ttc_ub4(tvb, offset, &value_len);
+	if ( len > 0 && value_len > 0 )
+	{
+		str_len = tns_get_ttc_bytes(tvb, offset + len, ttc_field_version, &value_offset, &value_len);
+		if ( str_len == 0 )
+			return 0;
+	}
+
+	return len + str_len;
+}
+
+/*
+ * Describe Information of a query, the select list. Only the number of
+ * columns and whether all of them are plain is kept, the column metadata
+ * is walked over. Returns the offset behind the message, or -1 if it
+ * does not decode or has a layout of a later TTC field version.
+ */
+static int tns_walk_describe(tvbuff_t *tvb, int offset, guint8 ttc_field_version, guint32 *columns, gboolean *plain)
+{
+	guint64 value64;
+	guint32 count, value;
+	int value_offset, len;
+
+#define TNS_DESCRIBE_UB(reader, var) \
+	do { \
+		len = reader(tvb, offset, (var)); \
+		if ( len == 0 ) \
+			return -1; \
+		offset += len; \
+	} while (0)
+#define TNS_DESCRIBE_BYTES(skipper) \
+	do { \
+		len = skipper; \
+		if ( len == 0 ) \
+			return -1; \
+		offset += len; \
+	} while (0)
+
+	if ( ttc_field_version == 0 || ttc_field_version > TTC_FIELD_VERSION_23_1_EXT1 )
+		return -1;
+
+	TNS_DESCRIBE_BYTES(tns_get_ttc_bytes(tvb, offset, ttc_field_version, &value_offset, &value));
+	TNS_DESCRIBE_UB(tns_get_ttc_ub4, &value);          /* maximum row size */
+	TNS_DESCRIBE_UB(tns_get_ttc_ub4, &count);
+
+	/* every column takes a couple of dozen bytes at least */
+	if ( count > (guint32) tvb_reported_length_remaining(tvb, offset) )
+		return -1;
+	if ( count > 0 )
+		offset += 1;
+
+	*columns = count;
+	*plain = TRUE;
+	for (guint32 i = 0; i < count; i++)
+	{
+		if ( !tvb_bytes_exist(tvb, offset, 4) )
+			return -1;
+
+		/* data type, flags, precision and scale bytes */
+		if ( !tns_plain_column_type(tvb_get_guint8(tvb, offset)) )
+			*plain = FALSE;
+		offset += 4;
+
+		TNS_DESCRIBE_UB(tns_get_ttc_ub4, &value);  /* buffer size */
+		TNS_DESCRIBE_UB(tns_get_ttc_ub4, &value);  /* maximum array elements */
+		TNS_DESCRIBE_UB(tns_get_ttc_ub8, &value64); /* continuation flags */
+		TNS_DESCRIBE_BYTES(tns_skip_ttc_string(tvb, offset, ttc_field_version)); /* type OID */
+		TNS_DESCRIBE_UB(tns_get_ttc_ub2, &value);  /* type version */
+		TNS_DESCRIBE_UB(tns_get_ttc_ub2, &value);  /* character set id */
+		offset += 1;                               /* character set form */
+		TNS_DESCRIBE_UB(tns_get_ttc_ub4, &value);  /* maximum size */
+		if ( ttc_field_version >= TTC_FIELD_VERSION_12_2 )
+			TNS_DESCRIBE_UB(tns_get_ttc_ub4, &value);  /* column id */
+		offset += 2;                               /* nullable, v7 name length */
+		TNS_DESCRIBE_BYTES(tns_skip_ttc_string(tvb, offset, ttc_field_version)); /* name */
+		TNS_DESCRIBE_BYTES(tns_skip_ttc_string(tvb, offset, ttc_field_version)); /* schema */
+		TNS_DESCRIBE_BYTES(tns_skip_ttc_string(tvb, offset, ttc_field_version)); /* type name */
+		TNS_DESCRIBE_UB(tns_get_ttc_ub2, &value);  /* position */
+		TNS_DESCRIBE_UB(tns_get_ttc_ub4, &value);  /* UDS flags */
+		if ( ttc_field_version >= TTC_FIELD_VERSION_23_1 )
+		{
+			TNS_DESCRIBE_BYTES(tns_skip_ttc_string(tvb, offset, ttc_field_version)); /* domain schema */
+			TNS_DESCRIBE_BYTES(tns_skip_ttc_string(tvb, offset, ttc_field_version)); /* domain name */
+		}
+	}
+
+	/* current date, then the describe flags and bounds and the query key */
+	TNS_DESCRIBE_UB(tns_get_ttc_ub4, &value);
+	if ( value > 0 )
+		TNS_DESCRIBE_BYTES(tns_get_ttc_bytes(tvb, offset, ttc_field_version, &value_offset, &value));
+	for (int i = 0; i < 4; i++)
+		TNS_DESCRIBE_UB(tns_get_ttc_ub4, &value);
+	TNS_DESCRIBE_UB(tns_get_ttc_ub4, &value);
+	if ( value > 0 )
+		TNS_DESCRIBE_BYTES(tns_get_ttc_bytes(tvb, offset, ttc_field_version, &value_offset, &value));
+
+#undef TNS_DESCRIBE_UB
+#undef TNS_DESCRIBE_BYTES
+
+	return offset;
+}
+
+/**
+ * @brief Rows of a fetch response, see tns_walk_fetch()
+ */
+typedef struct {
+	guint32 columns;              /* select list, 0 if unknown */
+	gboolean plain_columns;
+	int describe_offset;          /* -1 if the response has no describe */
+	int describe_end;
+	int rows_offset;              /* first row header or row, -1 if none */
+	int rows_end;
+	guint32 rows;
+	gboolean complete;            /* rows walked up to the message behind them */
+	int status_offset;            /* Return Status behind the rows, -1 if not reached */
+	guint32 status_code;          /* Oracle error code of the status */
+	guint32 status_cursor_id;
+} tns_fetch_t;
+
+/*
+ * Walk the messages of a response from the one at offset (its id already
+ * consumed): the describe of a query, then row headers, bit vectors and
+ * rows. Every row holds a value for each column of the select list, less
+ * the ones a bit vector marks as repeating the previous row. The walk is
+ * complete when a Return Status or Return OPI Parameter follows the rows.
+ */
+static void tns_walk_fetch(tvbuff_t *tvb, int offset, guint msg_id, guint8 ttc_field_version,
+			   guint8 ttc_version, tns_fetch_t *fetch)
+{
+	int bit_vector = -1;          /* offset of the columns sent in the next row */
+	guint32 value, count;
+	int len;
+
+	fetch->describe_offset = -1;
+	fetch->rows_offset = -1;
+	fetch->status_offset = -1;
+
+	for (;;)
+	{
+		int msg_offset = offset - 1;
+
+		switch (msg_id)
+		{
+			case SQLNET_DESCRIBE_INFO:
+				offset = tns_walk_describe(tvb, offset, ttc_field_version, &fetch->columns, &fetch->plain_columns);
+				if ( offset < 0 )
+					return;
+				fetch->describe_offset = msg_offset;
+				fetch->describe_end = offset;
+				break;
+
+			case SQLNET_ROW_TRANSF_HDR:
+			{
+				if ( fetch->rows_offset < 0 )
+					fetch->rows_offset = msg_offset;
+
+				/* flags, requests, iteration, iterations, buffer length */
+				if ( !tvb_bytes_exist(tvb, offset, 1) )
+					return;
+				offset += 1;
+				for (int i = 0; i < 4; i++)
+				{
+					len = tns_get_ttc_ub4(tvb, offset, &value);
+					if ( len == 0 )
+						return;
+					offset += len;
+				}
+
+				/* bit vector of the next row behind a repeated length */
+				len = tns_get_ttc_ub4(tvb, offset, &count);
+				if ( len == 0 )
+					return;
+				offset += len;
+				if ( count > 0 )
+				{
+					if ( !tvb_bytes_exist(tvb, offset, 1 + count) )
+						return;
+					bit_vector = offset + 1;
+					offset += 1 + count;
+				}
+
+				/* row id of the row header */
+				len = tns_get_ttc_ub4(tvb, offset, &count);
+				if ( len == 0 )
+					return;
+				offset += len;
+				if ( count > 0 )
+				{
+					int value_offset;
+
+					len = tns_get_ttc_bytes(tvb, offset, ttc_field_version, &value_offset, &value);
+					if ( len == 0 )
+						return;
+					offset += len;
+				}
+				break;
+			}
+
+			case SQLNET_BIT_VECTOR:
+				/* columns sent (ub2), then a bit per column */
+				if ( fetch->columns == 0 )
+					return;
+				len = tns_get_ttc_ub2(tvb, offset, &value);
+				if ( len == 0 || !tvb_bytes_exist(tvb, offset + len, (fetch->columns + 7) / 8) )
+					return;
+				bit_vector = offset + len;
+				offset = bit_vector + (fetch->columns + 7) / 8;
+				break;
+
+			case SQLNET_ROW_TRANSF_DATA:
+				if ( fetch->columns == 0 || !fetch->plain_columns )
+					return;
+				if ( fetch->rows_offset < 0 )
+					fetch->rows_offset = msg_offset;
+
+				for (guint32 col = 0; col < fetch->columns; col++)
+				{
+					/* a clear bit repeats the value of the previous row */
+					if ( bit_vector >= 0 &&
+					     (tvb_get_guint8(tvb, bit_vector + col / 8) & (1 << (col % 8))) == 0 )
+						continue;
+
+					len = tns_skip_ttc_value(tvb, offset, ttc_field_version);
+					if ( len == 0 )
+						return;
+					offset += len;
+				}
+				bit_vector = -1;
+				fetch->rows++;
+				fetch->rows_end = offset;
+				break;
+
+			case SQLNET_RETURN_STATUS:
+			{
+				/* see tns_cursor_response(), current row, return code
+				 * and cursor follow the call status and ECID sequence */
+				int first = ttc_version >= 3 ? 2 : 0;
+
+				fetch->complete = TRUE;
+				for (int i = 0; i <= first + 4; i++)
+				{
+					len = tns_get_ttc_ub4(tvb, offset, &value);
+					if ( len == 0 )
+						return;
+					offset += len;
+
+					if ( i == first + 1 )
+						fetch->status_code = value;
+					else if ( i == first + 4 )
+						fetch->status_cursor_id = value;
+				}
+				fetch->status_offset = msg_offset + 1;
+				return;
+			}
+
+			case SQLNET_RETURN_OPI_PARAM:
+				fetch->complete = TRUE;
+				return;
+
+			default:
+				return;
+		}
+
+		if ( !tvb_bytes_exist(tvb, offset, 1) )
+			return;
+		msg_id = tvb_get_guint8(tvb, offset);
+		offset += 1;
+	}
+}
+
+/*
+ * Count the rows of a response to an execute or fetch call. The select
+ * list comes with the describe of the response or from the cursor, the
+ * row totals of the cursor are updated with it (first pass only). A
+ * fetch that returned fewer rows than the threshold while more were
+ * pending points at a small fetch array size.
+ */
+static void tns_fetch_response(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, int offset,
+			       tns_conv_info_t *tns_info, guint msg_id)
+{
+	tns_pdu_info_t *pdu_info;
+	tns_call_t *call;
+	tns_fetch_t fetch = {};
+	proto_item *pi;
+
+	if ( !PINFO_FD_VISITED(pinfo) )
+	{
+		call = tns_info->pending_call;
+		if ( call && call->cursor_id != 0 )
+		{
+			tns_cursor_t *cursor = tns_cursor_lookup(tns_info, call->cursor_id);
+
+			if ( cursor )
+			{
+				call->columns = cursor->columns;
+				call->plain_columns = cursor->plain_columns;
+			}
+		}
+	}
+	else
+	{
+		pdu_info = tns_find_pdu_info(pinfo);
+		call = pdu_info ? pdu_info->call : NULL;
+	}
+
+	if ( !call )
+		return;
+
+	fetch.columns = call->columns;
+	fetch.plain_columns = call->plain_columns;
+	tns_walk_fetch(tvb, offset, msg_id, tns_info->ttc_field_version, tns_info->ttc_version, &fetch);
+
+	if ( fetch.describe_offset >= 0 )
+	{
+		proto_tree_add_uint(tree, hf_tns_fetch_columns, tvb, fetch.describe_offset,
+			fetch.describe_end - fetch.describe_offset, fetch.columns);
+	}
+
+	/* the Return Status behind the rows opens a new cursor */
+	if ( fetch.status_offset >= 0 )
+	{
+		tns_cursor_response(tvb, pinfo, tree, fetch.status_offset, tns_info, SQLNET_RETURN_STATUS);
+	}
+
+	if ( !PINFO_FD_VISITED(pinfo) && fetch.complete )
+	{
+		guint32 cursor_id = call->cursor_id != 0 ? call->cursor_id : fetch.status_cursor_id;
+		tns_cursor_t *cursor = cursor_id != 0 ? tns_cursor_lookup(tns_info, cursor_id) : NULL;
+
+		if ( cursor && fetch.describe_offset >= 0 )
+		{
+			cursor->columns = fetch.columns;
+			cursor->plain_columns = fetch.plain_columns;
+		}
+
+		/* a fetch, or an execute that returns rows; not a describe alone */
+		if ( fetch.rows_offset >= 0 || call->oci_func_id == SQLNET_USER_FUNC_OFETCH )
+		{
+			call->fetch_counted = TRUE;
+			call->fetch_rows = fetch.rows;
+			call->fetch_end = fetch.status_code == TNS_ORA_NO_DATA_FOUND ||
+				(call->fetch_requested > 0 && fetch.rows < call->fetch_requested);
+		}
+
+		if ( cursor && call->fetch_counted )
+		{
+			cursor->fetches++;
+			cursor->rows += fetch.rows;
+			call->cursor_fetches = cursor->fetches;
+			call->cursor_rows = cursor->rows;
+
+			/* the ending fetch returns less than the array size by nature */
+			if ( !call->fetch_end )
+			{
+				tns_fetch_sizes_add(cursor->fetch_sizes, fetch.rows);
+				cursor->fetch_samples++;
+			}
+			else if ( cursor->fetch_samples > 0 && !cursor->fetch_reported )
+			{
+				call->cursor_median = tns_fetch_median(cursor->fetch_sizes, cursor->fetch_samples);
+				call->cursor_median_fetches = cursor->fetch_samples;
+				cursor->fetch_reported = TRUE;
+			}
+		}
+	}
+
+	if ( !call->fetch_counted )
+		return;
+
+	if ( fetch.rows_offset >= 0 )
+		pi = proto_tree_add_uint(tree, hf_tns_fetch_rows, tvb, fetch.rows_offset,
+			fetch.rows_end - fetch.rows_offset, call->fetch_rows);
+	else
+		pi = proto_tree_add_uint(tree, hf_tns_fetch_rows, tvb, 0, 0, call->fetch_rows);
+	proto_item_set_generated(pi);
+
+	pi = proto_tree_add_boolean(tree, hf_tns_fetch_end, tvb, 0, 0, call->fetch_end);
+	proto_item_set_generated(pi);
+
+	if ( call->cursor_fetches > 0 )
+	{
+		pi = proto_tree_add_uint(tree, hf_tns_fetch_cursor_fetches, tvb, 0, 0, call->cursor_fetches);
+		proto_item_set_generated(pi);
+		pi = proto_tree_add_uint64(tree, hf_tns_fetch_cursor_rows, tvb, 0, 0, call->cursor_rows);
+		proto_item_set_generated(pi);
+	}
+
+	/* once per cursor, at the end of its rows */
+	if ( call->cursor_median_fetches > 0 )
+	{
+		pi = proto_tree_add_uint(tree, hf_tns_fetch_cursor_median, tvb, 0, 0, call->cursor_median);
+		proto_item_set_generated(pi);
+		if ( call->cursor_median < tns_fetch_rows_threshold )
+		{
+			expert_add_info_format(pinfo, pi, &ei_tns_fetch_rows_low,
+				"Cursor fetched a median of %u rows over %u fetches, below the threshold of %u",
+				call->cursor_median, call->cursor_median_fetches, tns_fetch_rows_threshold);
+		}
+	}
+}
+
+/*
+ * Client authentication call (get session key or authenticate), from the
+ * sequence byte: user pointer, user name length, mode, then the pointer
+ * and count of the key/value pairs and two output pointers, followed by
+ * the user name and the pairs. Each pair is the key and value length, the
+ * key and value (if not empty) and a flags word.
+ */
+static void tns_auth_request(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, int offset, tns_conv_info_t *tns_info)
+{
+	proto_tree *params_tree, *par_tree;
+	proto_item *params_ti, *par_ti;
+	guint64 token;
+	guint32 user_len, mode, pairs, len;
+	gboolean has_user, present;
+	int n, name_offset, value_offset;
+	guint32 name_len, value_len;
+
+	/* sequence number */
+	offset += 1;
+
+	if ( tns_info->ttc_field_version >= TTC_FIELD_VERSION_23_1_EXT1 )
+	{
+		if ( (n = tns_get_ttc_ub8(tvb, offset, &token)) == 0 )
+			return;
+		offset += n;
+	}
+
+	if ( (n = tns_get_ttc_ptr(tvb, offset, &has_user)) == 0 )
+		return;
+	offset += n;
+	if ( (n = tns_get_ttc_ub4(tvb, offset, &user_len)) == 0 )
+		return;
+	offset += n;
+	if ( (n = tns_get_ttc_ub4(tvb, offset, &mode)) == 0 )
+		return;
+	offset += n;
+	if ( (n = tns_get_ttc_ptr(tvb, offset, &present)) == 0 )
+		return;
+	offset += n;
+	if ( (n = tns_get_ttc_ub4(tvb, offset, &pairs)) == 0 )
+		return;
+	offset += n;
+	/* output pairs and their count */
+	if ( !tvb_bytes_exist(tvb, offset, 2) )
+		return;
+	offset += 2;
+
+	if ( has_user && user_len > 0 )
+	{
+		if ( (n = tns_get_ttc_bytes(tvb, offset, tns_info->ttc_field_version, &value_offset, &value_len)) == 0 )
+			return;
+		if ( value_offset < 0 || value_len != user_len )
+			return;
+
+		proto_tree_add_item(tree, hf_tns_session_user, tvb, value_offset, value_len, ENC_ASCII);
+		if ( !PINFO_FD_VISITED(pinfo) )
+		{
+			tns_session_set(pinfo, tns_info, TNS_SESSION_USER, (const gchar *) tvb_get_string_enc(wmem_file_scope(), tvb,
+				value_offset, value_len, ENC_ASCII));
+		}
+		offset += n;
+	}
+
+	params_tree = proto_tree_add_subtree(tree, tvb, offset, -1, ett_tns_opi_params, &params_ti, "Parameters");
+
+	for (guint32 par = 1; par <= pairs; par++)
+	{
+		int par_start = offset;
+
+		par_tree = proto_tree_add_subtree_format(params_tree, tvb, offset, -1, ett_tns_opi_par, &par_ti, "Parameter %u", par);
+
+		name_offset = value_offset = -1;
+		name_len = value_len = 0;
+
+		if ( (n = tns_get_ttc_ub4(tvb, offset, &len)) == 0 )
+			return;
+		offset += n;
+		if ( len > 0 )
+		{
+			if ( (n = tns_get_ttc_bytes(tvb, offset, tns_info->ttc_field_version, &name_offset, &name_len)) == 0 )
+				return;
+			if ( name_offset >= 0 )
+				proto_tree_add_item(par_tree, hf_tns_data_opi_param_name, tvb, name_offset, name_len, ENC_ASCII);
+			offset += n;
+		}
+
+		if ( (n = tns_get_ttc_ub4(tvb, offset, &len)) == 0 )
+			return;
+		offset += n;
+		if ( len > 0 )
+		{
+			if ( (n = tns_get_ttc_bytes(tvb, offset, tns_info->ttc_field_version, &value_offset, &value_len)) == 0 )
+				return;
+			if ( value_offset >= 0 )
+				proto_tree_add_item(par_tree, hf_tns_data_opi_param_value, tvb, value_offset, value_len, ENC_ASCII);
+			offset += n;
+		}
+
+		/* flags */
+		if ( (n = tns_get_ttc_ub4(tvb, offset, &len)) == 0 )
+			return;
+		offset += n;
+
+		proto_item_set_len(par_ti, offset - par_start);
+
+		if ( name_offset >= 0 && value_offset >= 0 )
+		{
+			tns_session_set_param(pinfo, tns_info, tvb, name_offset, name_len, value_offset, value_len);
+		}
+	}
+	proto_item_set_end(params_ti, tvb, offset);
+}
+
+/*
+ * Locate a byte pattern in place, without copying the tvb contents.
+ * The first pattern byte is searched with memchr(), which the C library
+ * implements with vector instructions, the remaining bytes are compared
+ * at the candidate position only. A negative maxlength searches to the
+ * end of the captured data. Returns the offset of the match or -1.
+ */
+static gint tns_find_pattern(tvbuff_t *tvb, const gint offset, const gint maxlength,
+			     const guint8 *pattern, const gint pattern_len)
+{
+	const guint8 *base, *p, *end;
+	gint avail;
+
+	avail = tvb_captured_length_remaining(tvb, offset);
+	if (maxlength >= 0 && maxlength < avail)
+		avail = maxlength;
+	if (pattern_len <= 0 || avail < pattern_len)
+		return -1;
+
+	base = tvb_get_ptr(tvb, offset, avail);
+	/* one past the last position a complete match can start at */
+	end = base + avail - pattern_len + 1;
+
+	for (p = base; p < end; p++) {
+		p = (const guint8 *) memchr(p, pattern[0], end - p);
+		if (p == NULL)
+			break;
+		if (memcmp(p + 1, pattern + 1, pattern_len - 1) == 0)
+			return offset + (gint) (p - base);
+	}
+
+	return -1;
+}
+
+//#define _DISSECTOR_SQL_DEBUG
+
+/* Parameter descriptor magic (0x0300 0x0001) and the maximum distance
+ * it is searched for behind the parameter header */
+static const guint8 ttci_pd_magic[] = { 0x03, 0x00, 0x00, 0x01 };
+#define TTCI_PD_MAGIC_SCAN_MAX 512
+
+/* Labels are only worth formatting if somebody is going to look at them */
+#define TNS_TREE_VISIBLE(tree) ((tree) != NULL && PTREE_DATA(tree)->visible)
+
+/* Bind fields added by dissect_tns_data_sql_binds() */
+static int * const ttci_bind_hf_list[] = {
+	&hf_tns_bind_index,
+	&hf_tns_bind_type,
+	&hf_tns_bind_length,
+	&hf_tns_bind_value,
+	&hf_tns_bind_data,
+	&hf_tns_bind_number,
+	&hf_tns_bind_integer,
+	&hf_tns_bind_time,
+	&hf_tns_bind_tz_offset,
+};
+
+/* "00" "01" ... "99", the two characters of each base 100 digit */
+static const char ttci_digit_pairs[] =
+	"0001020304050607080910111213141516171819"
+	"2021222324252627282930313233343536373839"
+	"4041424344454647484950515253545556575859"
+	"6061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+#define TTCI_NUMBER_MAX_LEN 21   /* exponent byte and 20 mantissa digits */
+#define TTCI_NUMBER_STR_MAX 176  /* sign, "0.", 64 zero pairs, 20 pairs, NUL */
+
+/*
+ * Oracle NUMBER: an exponent byte followed by up to 20 base 100 mantissa
+ * digits, the first one weighted by 100^exponent. Positive numbers have
+ * the high bit of the exponent set and store each digit + 1. Negative
+ * numbers store the complement of the exponent, each digit as 101 - digit
+ * and a 102 terminator if there are less than 20 digits. Zero is a single
+ * 0x80.
+ *
+ * The exact decimal string is assembled two characters at a time from
+ * ttci_digit_pairs. The value is also returned as integer if it is
+ * integral and fits into 18 decimal digits. Returns FALSE for infinity
+ * and malformed encodings.
+ */
+static gboolean ttci_decode_number(const guint8 *data, guint len, char *str, gint64 *ival, gboolean *is_integer)
+{
+	guint8 digits[TTCI_NUMBER_MAX_LEN - 1];
+	guint ndigits = 0;
+	gboolean negative, fraction = FALSE;
+	int exponent;
+	char *p = str;
+
+	if ( len == 0 || len > TTCI_NUMBER_MAX_LEN )
+		return FALSE;
+
+	if ( len == 1 && data[0] == 0x80 )
+	{
+		str[0] = '0';
+		str[1] = '\0';
+		*ival = 0;
+		*is_integer = TRUE;
+		return TRUE;
+	}
+
+	negative = !(data[0] & 0x80);
+	if ( negative )
+	{
+		exponent = (~data[0] & 0x7f) - 65;
+		if ( data[len - 1] == 102 )
+			len--;
+		for (guint i = 1; i < len; i++)
+		{
+			if ( data[i] < 2 || data[i] > 101 )
+				return FALSE;
+			digits[ndigits++] = 101 - data[i];
+		}
+	}
+	else
+	{
+		exponent = (data[0] & 0x7f) - 65;
+		for (guint i = 1; i < len; i++)
+		{
+			if ( data[i] < 1 || data[i] > 100 )
+				return FALSE;
+			digits[ndigits++] = data[i] - 1;
+		}
+	}
+
+	/* infinity is a lone 0x00 or 0xff 0x65, rejected above */
+	if ( ndigits == 0 )
+		return FALSE;
+
+	if ( negative )
+		*p++ = '-';
+
+	if ( exponent < 0 )
+	{
+		*p++ = '0';
+		*p++ = '.';
+		for (int i = -1; i > exponent; i--)
+		{
+			*p++ = '0';
+			*p++ = '0';
+		}
+		for (guint i = 0; i < ndigits; i++, p += 2)
+			memcpy(p, &ttci_digit_pairs[digits[i] * 2], 2);
+		fraction = TRUE;
+	}
+	else
+	{
+		for (guint i = 0; i <= (guint) exponent; i++)
+		{
+			guint8 d = i < ndigits ? digits[i] : 0;
+
+			/* no leading zero */
+			if ( i == 0 && d < 10 )
+			{
+				*p++ = '0' + d;
+				continue;
+			}
+			memcpy(p, &ttci_digit_pairs[d * 2], 2);
+			p += 2;
+		}
+		if ( ndigits > (guint) exponent + 1 )
+		{
+			*p++ = '.';
+			for (guint i = exponent + 1; i < ndigits; i++, p += 2)
+				memcpy(p, &ttci_digit_pairs[digits[i] * 2], 2);
+			fraction = TRUE;
+		}
+	}
+
+	/* the last digit is not 0, but its pair may end with one */
+	if ( fraction && p[-1] == '0' )
+		p--;
+	*p = '\0';
+
+	*is_integer = !fraction && exponent < 9;
+	if ( *is_integer )
+	{
+		gint64 value = 0;
+
+		for (guint i = 0; i <= (guint) exponent; i++)
+			value = value * 100 + (i < ndigits ? digits[i] : 0);
+		*ival = negative ? -value : value;
+	}
+
+	return TRUE;
+}
+
+/* Statement fields added by dissect_tns_data_sql() */
+static int * const ttci_stmt_hf_list[] = {
+	&hf_tns_oall8_token,
+	&hf_tns_oall8_options,
+	&hf_tns_oall8_cursor,
+	&hf_tns_oall8_sql_length,
+	&hf_tns_oall8_al8i4_length,
+	&hf_tns_oall8_prefetch_rows,
+	&hf_tns_oall8_max_long_size,
+	&hf_tns_oall8_bind_count,
+	&hf_tns_oall8_define_count,
+	&hf_tns_data_ttic_pkt_unknown_3,
+	&hf_tns_data_ttic_data_direction,
+	&hf_tns_data_ttic_param_count,
+	&hf_tns_data_ttic_stmt_sql,
+	&hf_tns_sql_fingerprint,
+	&hf_tns_sql_verb,
+};
+
+/*
+ * Is any of the given fields needed by a filter, a column or a visible
+ * tree? proto_field_is_referenced() returns on the first check for a
+ * visible tree and FALSE without any tree.
+ */
+static gboolean tns_fields_referenced(proto_tree *tree, int * const *hf_list, int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		if (proto_field_is_referenced(tree, *hf_list[i]))
+		{
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+/* Oracle DATE, TIMESTAMP and TIMESTAMP WITH TIME ZONE value lengths */
+#define TTCI_DATE_LEN          7
+#define TTCI_TIMESTAMP_LEN     11
+#define TTCI_TIMESTAMP_TZ_LEN  13
+
+/* Days since 1970-01-01 of a proleptic Gregorian date, without a loop
+ * or table (H. Hinnant's days_from_civil) */
+static gint64 tns_days_from_civil(gint64 year, guint month, guint day)
+{
+	gint64 era;
+	guint yoe, doy, doe;
+
+	year -= month <= 2;
+	era = (year >= 0 ? year : year - 399) / 400;
+	yoe = (guint) (year - era * 400);
+	doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+	doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+	return era * 146097 + (gint64) doe - 719468;
+}
+
+/*
+ * Oracle DATE: century + 100, year of century + 100, month, day, and
+ * hour, minute, second each + 1. TIMESTAMP appends the nanoseconds
+ * (big endian), TIMESTAMP WITH TIME ZONE the zone hour + 20 and minute
+ * + 60; its date and time are in UTC then. A zone hour with the high bit
+ * set is a region id, which leaves the zone offset unknown.
+ * The date and time are returned as UTC.
+ */
+static gboolean ttci_decode_datetime(const guint8 *data, guint len, nstime_t *ts, gint32 *tz_minutes, gboolean *has_tz)
+{
+	gint64 year, days;
+	guint month, day, hour, minute, second;
+	guint32 nsecs = 0;
+
+	if ( len != TTCI_DATE_LEN && len != TTCI_TIMESTAMP_LEN && len != TTCI_TIMESTAMP_TZ_LEN )
+		return FALSE;
+
+	year = ((gint64) data[0] - 100) * 100 + ((gint64) data[1] - 100);
+	month = data[2];
+	day = data[3];
+	hour = data[4] - 1u;
+	minute = data[5] - 1u;
+	second = data[6] - 1u;
+
+	/* the unsigned wrap-around catches the zero bytes as well */
+	if ( month - 1u > 11 || day - 1u > 30 || hour > 23 || minute > 59 || second > 59 )
+		return FALSE;
+
+	if ( len >= TTCI_TIMESTAMP_LEN )
+	{
+		nsecs = pntoh32(&data[7]);
+		if ( nsecs > 999999999 )
+			return FALSE;
+	}
+
+	*has_tz = FALSE;
+	if ( len == TTCI_TIMESTAMP_TZ_LEN && !(data[11] & 0x80) )
+	{
+		*tz_minutes = ((gint32) data[11] - 20) * 60 + ((gint32) data[12] - 60);
+		*has_tz = TRUE;
+	}
+
+	days = tns_days_from_civil(year, month, day);
+	ts->secs = (time_t) (days * 86400 + hour * 3600 + minute * 60 + second);
+	ts->nsecs = (int) nsecs;
+
+	return TRUE;
+}
+
+/* TCC/TCI Add the parsed bind values to the tree */
+static void dissect_tns_data_sql_binds(tvbuff_t *tvb, packet_info *pinfo, proto_tree *data_tree, ttci_packet_t* pttci)
+{
+	proto_tree *pd_tree, *bind_tree;
+	proto_item *bind_ti, *pi;
+	gboolean visible;
+	char num_str[TTCI_NUMBER_STR_MAX];
+	gint64 num_ival;
+	gboolean num_is_integer;
+	nstime_t ts;
+	gint32 tz_minutes;
+	gboolean has_tz;
+
+	/* nothing to add without a tree (first pass, taps only) */
+	if ( !data_tree || !pttci->bind_count )
+	{
+		return;
+	}
+
+	/* fields are still added for filters and -T fields, but
+	 * labels are only formatted for a visible tree */
+	visible = TNS_TREE_VISIBLE(data_tree);
+
+	pd_tree = proto_tree_add_subtree(data_tree, tvb, pttci->binds[0].offset, -1, ett_sql_params, NULL, "TTC/TTI SQL Parameters");
+
+	/*
+	 * Every bind is a subtree with the same set of fields, so any number
+	 * of binds is filterable, e.g. tns.bind.index == 3 && tns.bind.value == "x"
+	 */
+	for (guint i = 0; i < pttci->bind_count; i++)
+	{
+		const ttci_bind_t *bind = &pttci->binds[i];
+		tvbuff_t *value_tvb = tvb;
+		int value_offset = bind->offset + 1;
+
+		/* selection focus value incl. length byte */
+		bind_tree = proto_tree_add_subtree(pd_tree, tvb, bind->offset, bind->span, ett_sql_bind, &bind_ti, "Bind");
+
+		pi = proto_tree_add_uint(bind_tree, hf_tns_bind_index, tvb, 0, 0, i + 1);
+		proto_item_set_generated(pi);
+		pi = proto_tree_add_uint(bind_tree, hf_tns_bind_type, tvb, 0, 0, bind->kind);
+		proto_item_set_generated(pi);
+		proto_tree_add_uint(bind_tree, hf_tns_bind_length, tvb, bind->offset, 1, bind->length);
+
+		if (bind->chunked)
+		{
+			value_tvb = tns_chunked_value_tvb(tvb, pinfo, bind->offset, pttci->ttc_field_version, "Bind Value");
+			value_offset = 0;
+		}
+
+		if (bind->kind == TTCI_BIND_STRING)
+		{
+			const guint8 *str_value;
+
+			proto_tree_add_item_ret_string(bind_tree, hf_tns_bind_value, value_tvb, value_offset, bind->length,
+				ENC_UTF_8, pinfo->pool, &str_value);
+			if (visible)
+			{
+				proto_item_append_text(bind_ti, " %u (String): %s", i + 1, (const char*) str_value);
+			}
+		}
+		else if (bind->kind == TTCI_BIND_NUMBER &&
+			 ttci_decode_number(tvb_get_ptr(value_tvb, value_offset, bind->length), bind->length,
+					    num_str, &num_ival, &num_is_integer))
+		{
+			proto_tree_add_string(bind_tree, hf_tns_bind_value, value_tvb, value_offset, bind->length, num_str);
+			proto_tree_add_double(bind_tree, hf_tns_bind_number, value_tvb, value_offset, bind->length,
+				g_ascii_strtod(num_str, NULL));
+			if (num_is_integer)
+			{
+				proto_tree_add_int64(bind_tree, hf_tns_bind_integer, value_tvb, value_offset, bind->length, num_ival);
+			}
+			if (visible)
+			{
+				proto_item_append_text(bind_ti, " %u (Number): %s", i + 1, num_str);
+			}
+		}
+		else if (bind->kind == TTCI_BIND_DATETIME &&
+			 ttci_decode_datetime(tvb_get_ptr(value_tvb, value_offset, bind->length), bind->length,
+					      &ts, &tz_minutes, &has_tz))
+		{
+			proto_tree_add_time(bind_tree, hf_tns_bind_time, value_tvb, value_offset, bind->length, &ts);
+			if (has_tz)
+			{
+				proto_tree_add_int(bind_tree, hf_tns_bind_tz_offset, value_tvb, value_offset + TTCI_TIMESTAMP_LEN, 2, tz_minutes);
+			}
+			if (visible)
+			{
+				proto_item_append_text(bind_ti, " %u (Date/Time): %s", i + 1,
+					abs_time_to_str(pinfo->pool, &ts, ABSOLUTE_TIME_UTC, TRUE));
+			}
+		}
+		/* undecoded or malformed */
+		else
+		{
+			proto_tree_add_item(bind_tree, hf_tns_bind_data, value_tvb, value_offset, bind->length, ENC_NA);
+			if (visible)
+			{
+				proto_item_append_text(bind_ti, " %u (%s): %s", i + 1,
+					val_to_str_const(bind->kind, ttci_bind_kinds, "Unknown"),
+					tvb_bytes_to_str_punct(pinfo->pool, value_tvb, value_offset, bind->length, ' '));
+			}
+		}
+	}
+}
+
+/* TCC/TCI Parse SQL parameter block, records the bind values in pttci */
+static int dissect_tns_data_sql_params(tvbuff_t *tvb, packet_info *pinfo, int offset, ttci_packet_t* pttci)
+{
+	ttci_stmt_pd_hdr_t pd_header;
+	ttci_stmt_pd_itm_t* pd_list;
+	tns_span_t span;
+	int buff_offset;
+	int found_offset;
+	int bytes_remaining;
+	guint32 param_idx;
+
+	/* get remaining bytes of packet buffer */
+	bytes_remaining = tvb_reported_length_remaining(tvb, offset);
+
+#ifdef _DISSECTOR_SQL_DEBUG
+	fprintf(stdout, "%s: TTCI(offset=0x%04x) SQL:PARAMS:START pdhs=%d pdls=%d remaining=%d +++++++\n", 
+		__func__, offset, TTCI_STMT_PD_HDR_LEN, (int) sizeof(ttci_stmt_pd_itm_t) * (pttci->param_count + 1), bytes_remaining);
+#endif
+
+	/* at least header size + one parameter marker */
+	if ( bytes_remaining > TTCI_STMT_PD_HDR_LEN + 6 ) 
+	{
+		/* parameter descriptor list plus value list marker entry,
+		 * released together with the packet scope */
+		pd_list = wmem_alloc0_array(pinfo->pool, ttci_stmt_pd_itm_t, pttci->param_count + 1);
+
+		/* get SQL parameter header block */
+		ttci_get_stmt_pd_hdr(tvb, offset, &pd_header);
+
+#ifdef _DISSECTOR_SQL_DEBUG
+
+		fprintf(stdout, "%s: TTCI(offset=0x%04x) param_count=%d direction=0x%02x "
+						"flags=0x%02x type=0x%02x u1=0x%04x u2=0x%04x u3=0x%04x u4=0x%04x u5=0x%04x\n", 
+			__func__, offset, 
+			pttci->param_count,
+			pd_header.direction,
+			pd_header.flags,
+			pd_header.type,
+			pd_header.unknown_1,
+			pd_header.unknown_2,
+			pd_header.unknown_3,
+			pd_header.unknown_4,
+			pd_header.unknown_5);
+#endif
+
+		/* set offset of the parameter descriptor block */
+		if (pd_header.unknown_5 == 0x8002) {
+			/* header is one byte to short. found in sql 
+			 * statement with 1 parameter. */
+			buff_offset = offset + TTCI_STMT_PD_HDR_LEN - 1;
+		} else {
+			buff_offset = offset + TTCI_STMT_PD_HDR_LEN;
+		}
+
+		/* find first parameter block: one contiguous window, bounded
+		 * by TTCI_PD_MAGIC_SCAN_MAX bytes behind the header */
+		found_offset = tns_find_pattern(tvb, buff_offset, TTCI_PD_MAGIC_SCAN_MAX,
+						ttci_pd_magic, sizeof(ttci_pd_magic));
+
+#ifdef _DISSECTOR_SQL_DEBUG
+		fprintf(stdout, "%s: TTCI(offset=0x%04x) first descriptor at 0x%04x\n", 
+			__func__, buff_offset, found_offset);
+#endif
+
+		if (found_offset < 0) {
+			fprintf(stderr, "%s: TTC/TTI: Parameter descriptor not found. Abort! bytes_remaining=%d buff_offset=%d\n",
+				__func__, bytes_remaining, buff_offset);
+			goto exit_done;
+		}
+		buff_offset = found_offset;
+
+		/* load parameter descriptors, from one span that covers the
+		 * longest possible list (or the rest of the packet) */
+		tns_span_init(&span, tvb, buff_offset,
+			MIN(pttci->param_count, G_MAXINT / TTCI_STMT_PD_ITM_MAX_LEN) * TTCI_STMT_PD_ITM_MAX_LEN);
+
+		for (guint32 j = 0; j < pttci->param_count; j++) 
+		{
+			pd_list[j].magic_1 = tns_span_get_ntohs(&span);
+
+			pd_list[j].magic_2 = tns_span_get_ntohs(&span);
+
+			pd_list[j].flags = tns_span_get_guint8(&span);
+
+			/* end of descriptor list reached */
+			if (pd_list[j].magic_1 != 0x0300 && pd_list[j].magic_2 != 0x0001)
+			{
+				fprintf(stderr, "%s: TTC/TTI: Invalid parameter descriptor detected. Abort! offs=0x%04x ma1=0x%04x ma2=0x%04x flags=0x%02x\n",
+					__func__, tns_span_offset(&span), pd_list[j].magic_1, pd_list[j].magic_2, pd_list[j].flags);
+				goto exit_done;
+			}
+			
+			/* number/date/time parameter types: */
+			if (pd_list[j].flags == 0x16 || pd_list[j].flags == 0x07)
+			{
+				pd_list[j].param_props.unknown_1 = tns_span_get_ntohs(&span);
+				pd_list[j].param_props.unknown_2 = tns_span_get_guint8(&span);
+				pd_list[j].param_props.unknown_3 = tns_span_get_guint8(&span);
+
+				pd_list[j].param_marker.marker_1 = tns_span_get_ntohs(&span);
+				pd_list[j].param_marker.marker_2 = tns_span_get_ntohs(&span);
+				pd_list[j].param_marker.marker_3 = tns_span_get_ntohs(&span);
+			}
+			/* parameter type: */
+			else {
+				pd_list[j].param_props.unknown_1 = tns_span_get_ntohs(&span);
+				pd_list[j].param_props.unknown_2 = tns_span_get_guint8(&span);
+				pd_list[j].param_props.unknown_3 = tns_span_get_ntohs(&span);
+
+				pd_list[j].param_marker.marker_1 = tns_span_get_ntohs(&span);
+				pd_list[j].param_marker.marker_2 = tns_span_get_ntohs(&span);
+				pd_list[j].param_marker.marker_3 = tns_span_get_ntohs(&span);
+
+				if (pd_list[j].flags == 0x01 && pd_list[j].magic_2 == 0x0109)
+				{
+					/* reread marker 3 word */
+					pd_list[j].param_marker.marker_3 = tns_span_get_ntohs(&span);
+				}
+			}
+			
+#ifdef _DISSECTOR_SQL_DEBUG
+			fprintf(stdout, "%s: TTCI(offset=0x%04x) >> p=%d ma1=0x%04x ma2=0x%04x flags=0x%02x pu1=0x%04x pu2=0x%02x pu3=0x%04x pm1=0x%04x pm2=0x%04x pm3=0x%04x\n", 
+				__func__, tns_span_offset(&span), j + 1,
+				pd_list[j].magic_1,
+				pd_list[j].magic_2,
+				pd_list[j].flags,
+				pd_list[j].param_props.unknown_1,
+				pd_list[j].param_props.unknown_2,
+				pd_list[j].param_props.unknown_3,
+				pd_list[j].param_marker.marker_1,
+				pd_list[j].param_marker.marker_2,
+				pd_list[j].param_marker.marker_3);
+#endif
+			/* parameter value list marker reached */
+			if (pd_list[j].param_marker.marker_2 == 0x6901 && pd_list[j].param_marker.marker_3 == 0x0007)
+			{
+#ifdef _DISSECTOR_SQL_DEBUG
+				fprintf(stdout, "%s: TTCI(offset=0x%04x) buff_offset=0x%04x *** VALUE LIST REACHED ***\n", 
+					__func__, offset, tns_span_offset(&span));
+#endif
+				break;
+			}
+		}
+
+		/* set start of prameter value list */
+		offset = tns_span_offset(&span);
+
+		/* get remaining bytes of packet buffer */
+		if (!(bytes_remaining = tvb_reported_length_remaining(tvb, offset)))
+		{
+			goto exit_done;
+		}
+
+#ifdef _DISSECTOR_SQL_DEBUG
+		fprintf(stdout, "%s: TTCI(offset=0x%04x) SQL:VALUES:START remaining=%d +++++++\n", 
+			__func__, offset, bytes_remaining);
+#endif
+		/* walk the value list; only locations and kinds are recorded
+		 * here, formatting is left to dissect_tns_data_sql_binds().
+		 * They are kept with the frame record for later passes. */
+		pttci->binds = wmem_alloc_array(wmem_file_scope(), ttci_bind_t, pttci->param_count);
+
+		param_idx = 0;
+		for (int i=0, value_len=0;
+			 i < bytes_remaining && param_idx < pttci->param_count;
+			 param_idx++, i += value_len)
+		{
+			ttci_bind_t *bind;
+
+			if ( tvb_reported_length_remaining(tvb, offset) <= 0 )
+			{
+				fprintf(stderr, "%s: TTC/TTI: No bytes left, Abort!\n", __func__);
+				goto exit_done;				
+			}
+
+			value_len = tvb_get_guint8(tvb, offset);
+
+			/* valid value length */
+			if ( !value_len )
+			{
+				fprintf(stderr, "%s: TTC/TTI: Invalid parameter value length detected. Abort!\n", __func__);
+				goto exit_done;				
+			}
 
 #ifdef _DISSECTOR_SQL_DEBUG
-			fprintf(stdout, "%s: TTCI(offset=0x%04x) param_idx=%d flags=0x%02x pu1=0x%04x pu2=0x%04x pm3=0x%04x value_len=%d\n", 
-				__func__, offset, param_idx + 1, 
+			fprintf(stdout, "%s: TTCI(offset=0x%04x) param_idx=%u flags=0x%02x pu1=0x%04x pu2=0x%04x pm3=0x%04x value_len=%d\n", 
+				__func__, offset + 1, param_idx + 1, 
 				pd_list[param_idx].flags, 
 				pd_list[param_idx].param_props.unknown_1,
 				pd_list[param_idx].param_props.unknown_2, 
 				pd_list[param_idx].param_marker.marker_3, 
 				value_len);
 #endif
-			/* string field */
+			bind = &pttci->binds[pttci->bind_count++];
+			bind->offset = offset;
+
+			if ( value_len == TTCI_LONG_LENGTH_MARKER )
+			{
+				guint32 chunked_len;
+				int value_end;
+
+				value_end = tns_walk_chunks(tvb, offset, pttci->ttc_field_version, &chunked_len, NULL);
+				if ( value_end < 0 )
+				{
+#ifdef _DISSECTOR_SQL_DEBUG
+					fprintf(stdout, "%s: TTC/TTI: Incomplete chunked parameter value. Abort!\n", __func__);
+#endif
+					pttci->bind_count--;
+					goto exit_done;
+				}
+				bind->chunked = TRUE;
+				bind->length = chunked_len;
+				bind->span = value_end - offset;
+				value_len = bind->span - 1;
+			}
+			else
+			{
+				bind->chunked = FALSE;
+				bind->length = value_len;
+				bind->span = value_len + 1;
+			}
+
+			/* flags:
+			 * 0x16 => 0001 0110 --> pu1=0x0000 | pu2=0x0000 [VL=1 -> pm3=0x0007 or VL=2 -> pm3=0x0001]
+			 * 0x07 => 0000 0111 --> pu1=0x0000 | pu2=0x0000
+			 * 0x01 => 0000 0001 --> pu1=0x0b00 | pu2=0x0004 (date/time)
+			 */
 			if (pd_list[param_idx].param_props.unknown_2 & 0x10)
 			{
-				if (!(byte_buffer = malloc(value_len + 1)))
-				{
-					fprintf(stderr, "%s: TTC/TTI: Out of memory. Abort!\n", __func__);
-					goto exit_clenup_list;				
-				}
-				memset(byte_buffer, 0, value_len + 1);
+				bind->kind = TTCI_BIND_STRING;
+			}
+			else if ((pd_list[param_idx].param_props.unknown_1 == 0x0b00) &&
+				 (pd_list[param_idx].param_props.unknown_2 & 0x0004))
+			{
+				bind->kind = TTCI_BIND_DATETIME;
+			}
+			else
+			{
+				bind->kind = TTCI_BIND_NUMBER;
+			}
+
+			offset += bind->span;
+		}
+	}
+
+exit_done:
+#ifdef _DISSECTOR_SQL_DEBUG
+	fprintf(stdout, "%s: TTCI(offset=0x%04x) SQL:PARAMS:END --------\n", 
+		__func__, offset);
+#endif
+
+	return offset;
+}
+
+/* OALL8 execute options used to classify the statement */
+#define TTCI_OALL8_OPT_DEFINE   0x00000010
+#define TTCI_OALL8_OPT_FETCH    0x00000040
+
+/* Entries of the al8i4 array sent with every OALL8 call */
+#define TTCI_OALL8_AL8I4_LEN    13
+
+/**
+ * @brief OALL8 header fields, see ttci_decode_oall8()
+ */
+typedef struct {
+	guint32 options;
+	guint32 cursor_id;
+	int cursor_offset;      /* location of the cursor id */
+	int cursor_length;
+	gboolean has_sql;
+	guint32 sql_length;
+	guint32 prefetch_rows;
+	guint32 bind_count;
+	guint32 define_count;
+} ttci_oall8_hdr_t;
+
+/*
+ * Decode the header of an OALL8 call field by field, from the sequence
+ * byte at offset up to the statement text. The fields of interest are
+ * added to tree if it is not NULL. Returns the offset of the statement
+ * text (its length byte or chunk marker), or -1 if the header does not
+ * decode or does not match the text that follows.
+ */
+static int ttci_decode_oall8(tvbuff_t *tvb, proto_tree *tree, int offset, guint8 ttc_field_version, ttci_oall8_hdr_t *hdr)
+{
+	guint64 token;
+	guint32 value;
+	gboolean present;
+	int len;
+
+/* read a field or fail, optionally adding it to the tree */
+#define TTCI_OALL8_UB4(hf, var) \
+	do { \
+		len = tns_get_ttc_ub4(tvb, offset, (var)); \
+		if ( len == 0 ) \
+			return -1; \
+		proto_tree_add_uint(tree, (hf), tvb, offset, len, *(var)); \
+		offset += len; \
+	} while (0)
+#define TTCI_OALL8_SKIP_UB4() \
+	do { \
+		len = tns_get_ttc_ub4(tvb, offset, &value); \
+		if ( len == 0 ) \
+			return -1; \
+		offset += len; \
+	} while (0)
+#define TTCI_OALL8_PTR(var) \
+	do { \
+		len = tns_get_ttc_ptr(tvb, offset, (var)); \
+		if ( len == 0 ) \
+			return -1; \
+		offset += len; \
+	} while (0)
+
+	/* sequence number, shown as the TTC/TTI packet number */
+	offset += 1;
+
+	if ( ttc_field_version >= TTC_FIELD_VERSION_23_1_EXT1 )
+	{
+		len = tns_get_ttc_ub8(tvb, offset, &token);
+		if ( len == 0 )
+			return -1;
+		proto_tree_add_uint64(tree, hf_tns_oall8_token, tvb, offset, len, token);
+		offset += len;
+	}
+
+	TTCI_OALL8_UB4(hf_tns_oall8_options, &hdr->options);
+	hdr->cursor_offset = offset;
+	TTCI_OALL8_UB4(hf_tns_oall8_cursor, &hdr->cursor_id);
+	hdr->cursor_length = len;
+
+	TTCI_OALL8_PTR(&hdr->has_sql);
+	TTCI_OALL8_UB4(hf_tns_oall8_sql_length, &hdr->sql_length);
+
+	/* al8i4 array, its values follow the statement text */
+	TTCI_OALL8_PTR(&present);
+	TTCI_OALL8_UB4(hf_tns_oall8_al8i4_length, &value);
+	if ( !present || value != TTCI_OALL8_AL8I4_LEN )
+		return -1;
+
+	TTCI_OALL8_PTR(&present);          /* al8o4 */
+	TTCI_OALL8_PTR(&present);          /* al8o4l */
+	TTCI_OALL8_SKIP_UB4();             /* prefetch buffer size */
+	TTCI_OALL8_UB4(hf_tns_oall8_prefetch_rows, &hdr->prefetch_rows);
+	TTCI_OALL8_UB4(hf_tns_oall8_max_long_size, &value);
+
+	TTCI_OALL8_PTR(&present);          /* binds */
+	TTCI_OALL8_UB4(hf_tns_oall8_bind_count, &hdr->bind_count);
+
+	TTCI_OALL8_PTR(&present);          /* al8app */
+	TTCI_OALL8_PTR(&present);          /* al8txn */
+	TTCI_OALL8_PTR(&present);          /* al8txl */
+	TTCI_OALL8_PTR(&present);          /* al8kv */
+	TTCI_OALL8_PTR(&present);          /* al8kvl */
+
+	TTCI_OALL8_PTR(&present);          /* al8doac */
+	TTCI_OALL8_UB4(hf_tns_oall8_define_count, &hdr->define_count);
+
+	TTCI_OALL8_SKIP_UB4();             /* registration id */
+	TTCI_OALL8_PTR(&present);          /* al8objlist */
+	TTCI_OALL8_PTR(&present);          /* al8objlen */
+	TTCI_OALL8_PTR(&present);          /* al8blv */
+	TTCI_OALL8_SKIP_UB4();             /* al8blvl */
+	TTCI_OALL8_PTR(&present);          /* al8dnam */
+	TTCI_OALL8_SKIP_UB4();             /* al8dnaml */
+	TTCI_OALL8_SKIP_UB4();             /* al8regid_msb */
+	TTCI_OALL8_PTR(&present);          /* al8pidmlrc */
+	TTCI_OALL8_SKIP_UB4();             /* al8pidmlrcbl */
+
+	if ( ttc_field_version >= TTC_FIELD_VERSION_12_2 )
+	{
+		TTCI_OALL8_PTR(&present);      /* al8sqlsig */
+		TTCI_OALL8_SKIP_UB4();         /* SQL signature length */
+		TTCI_OALL8_PTR(&present);      /* SQL id */
+		TTCI_OALL8_SKIP_UB4();         /* SQL id size */
+		TTCI_OALL8_PTR(&present);      /* SQL id length */
+
+		if ( ttc_field_version >= TTC_FIELD_VERSION_12_2_EXT1 )
+		{
+			TTCI_OALL8_PTR(&present);      /* chunk ids */
+			TTCI_OALL8_SKIP_UB4();         /* number of chunk ids */
+		}
+	}
+
+#undef TTCI_OALL8_UB4
+#undef TTCI_OALL8_SKIP_UB4
+#undef TTCI_OALL8_PTR
+
+	/* every bind needs at least one byte of the message */
+	if ( hdr->bind_count > (guint32) tvb_reported_length_remaining(tvb, offset) )
+		return -1;
+
+	/* the statement text must have the announced length */
+	if ( hdr->has_sql && hdr->sql_length > 0 )
+	{
+		guint8 text_len;
+		guint32 chunked_length;
+
+		if ( !tvb_bytes_exist(tvb, offset, 1) )
+			return -1;
+
+		text_len = tvb_get_guint8(tvb, offset);
+		if ( text_len == TTCI_LONG_LENGTH_MARKER )
+		{
+			if ( tns_walk_chunks(tvb, offset, ttc_field_version, &chunked_length, NULL) < 0 ||
+			     chunked_length != hdr->sql_length )
+				return -1;
+		}
+		else if ( text_len != hdr->sql_length )
+		{
+			return -1;
+		}
+	}
+
+	return offset;
+}
+
+/*
+ * Cursor and rows asked for by an execute or fetch call, kept with the
+ * call to judge the rows of its response. OALL8 has them in its header,
+ * a fetch call sends the ub4 cursor and row count behind the sequence
+ * byte and token. Returns the offset of the cursor id, -1 if it is not
+ * found.
+ */
+static int tns_fetch_request(tvbuff_t *tvb, proto_tree *tree, int offset, guint32 oci_func_id,
+			     guint8 ttc_field_version, ttci_packet_t *pttci)
+{
+	guint64 token;
+	int len, cursor_len;
+
+	if ( oci_func_id == SQLNET_USER_FUNC_OALL8 )
+	{
+		ttci_oall8_hdr_t hdr = {};
+
+		if ( ttci_decode_oall8(tvb, NULL, offset, ttc_field_version, &hdr) < 0 )
+		{
+			return -1;
+		}
+		pttci->fetch_cursor_id = hdr.cursor_id;
+		pttci->fetch_rows = hdr.prefetch_rows;
+		return hdr.cursor_offset;
+	}
+
+	/* sequence number */
+	offset += 1;
+
+	if ( ttc_field_version >= TTC_FIELD_VERSION_23_1_EXT1 )
+	{
+		len = tns_get_ttc_ub8(tvb, offset, &token);
+		if ( len == 0 )
+			return -1;
+		offset += len;
+	}
+
+	cursor_len = tns_get_ttc_ub4(tvb, offset, &pttci->fetch_cursor_id);
+	if ( cursor_len == 0 )
+		return -1;
+
+	len = tns_get_ttc_ub4(tvb, offset + cursor_len, &pttci->fetch_rows);
+	if ( len > 0 )
+	{
+		proto_tree_add_uint(tree, hf_tns_fetch_requested, tvb, offset + cursor_len, len, pttci->fetch_rows);
+	}
+
+	return offset;
+}
+
+/* Longest statement header of the fixed layout */
+#define TTCI_STMT_HDR_MAX_LEN 27
+
+/* TCC/TCI Locate SQL statement header and text, records the offsets in pttci */
+static int dissect_tns_data_sql_stmt(tvbuff_t *tvb, int offset, ttci_packet_t* pttci)
+{
+	static const guint8 ttci_stmt_terminator[] = { 0x01, 0x01 };
+	gint stmt_length = 0;
+	gint stmt_end;
+	guint32 chunked_length;
+	tns_span_t span;
+	int bytes_remaining;
+	int tv_disp_offset = -1;
+	int hdr_jmp_len;
+
+	pttci->parse_state = TTCI_PARSED_STMT;
+	pttci->unknown_3_offset = -1;
+	pttci->direction_offset = -1;
+	pttci->param_count_offset = -1;
+
+	/* OALL8 headers are decoded field by field, the fixed layout below
+	 * is kept for headers that do not decode */
+	if ( pttci->oall8_offset >= 0 )
+	{
+		ttci_oall8_hdr_t hdr = {};
+		int stmt_offset;
+
+		stmt_offset = ttci_decode_oall8(tvb, NULL, pttci->oall8_offset, pttci->ttc_field_version, &hdr);
+		if ( stmt_offset >= 0 )
+		{
+			pttci->oall8_decoded = TRUE;
+			pttci->param_count = hdr.bind_count;
+			pttci->data_direction = (hdr.define_count > 0 || (hdr.options & TTCI_OALL8_OPT_FETCH)) ?
+				SQLNET_TTCI_STMT_GET_DATA : SQLNET_TTCI_STMT_SET_DATA;
+
+			if ( !hdr.has_sql || hdr.sql_length == 0 )
+			{
+				return stmt_offset;
+			}
+
+			if ( tvb_get_guint8(tvb, stmt_offset) == TTCI_LONG_LENGTH_MARKER )
+			{
+				guint32 chunked_length;
+
+				pttci->stmt_offset = stmt_offset;
+				pttci->stmt_chunked = TRUE;
+				pttci->stmt_length = hdr.sql_length;
+				return tns_walk_chunks(tvb, stmt_offset, pttci->ttc_field_version, &chunked_length, NULL);
+			}
+
+			pttci->stmt_offset = stmt_offset + 1;
+			pttci->stmt_length = hdr.sql_length;
+			return pttci->stmt_offset + pttci->stmt_length;
+		}
+	}
+
+	if ( tvb_reported_length_remaining(tvb, offset) > 19 )
+	{
+		tns_span_init(&span, tvb, offset, TTCI_STMT_HDR_MAX_LEN);
+
+		pttci->unknown_2 = tns_span_get_ntohs(&span);
+
+		pttci->unknown_3_offset = tns_span_offset(&span);
+		pttci->unknown_3 = tns_span_get_ntohs(&span);
+
+#ifdef _DISSECTOR_SQL_DEBUG
+		fprintf(stdout, "%s: TTCI(offset=0x%04x) unknown_2=0x%04x unknown_3=0x%04x (%d)\n",
+			__func__, tns_span_offset(&span), 
+			pttci->unknown_2, 
+			pttci->unknown_3,
+			pttci->unknown_3);
+#endif
+
+		/* should be 0x01 or 0x33 or 0x35 */
+		pttci->stmt_byte1 = tns_span_get_guint8(&span);
+		
+		/* offset increased one step */
+		if (pttci->stmt_byte1 != 0x01) {
+			pttci->stmt_byte1_prfx = pttci->stmt_byte1;
+			/* should be 0x01 */
+			pttci->stmt_byte1 = tns_span_get_guint8(&span);
+		}
+
+		/* should be 0x01 */
+		pttci->stmt_byte2 = tns_span_get_guint8(&span);
+
+		/* should be 0x0d */
+		pttci->stmt_byte3 = tns_span_get_guint8(&span);
+
+#ifdef _DISSECTOR_SQL_DEBUG
+		fprintf(stdout, "%s: TTCI(offset=0x%04x) prfx=0x%02x stmt_byte1=0x%02x stmt_byte2=0x%02x stmt_byte3=0x%02x\n", 
+			__func__, tns_span_offset(&span), 
+			pttci->stmt_byte1_prfx, 
+			pttci->stmt_byte1, 
+			pttci->stmt_byte2, 
+			pttci->stmt_byte3);
+#endif
+
+		/* should be 0x0000 */
+		pttci->stmt_sign1 = tns_span_get_ntohs(&span);
+
+		/* should be 0x04 */
+		pttci->stmt_sign2 = tns_span_get_guint8(&span);
+
+#ifdef _DISSECTOR_SQL_DEBUG		
+		fprintf(stdout, "%s: TTCI(offset=0x%04x) stmt_sign1=0x%04x stmt_sign2=0x%02x\n",
+			__func__, tns_span_offset(&span), 
+			pttci->stmt_sign1, 
+			pttci->stmt_sign2);
+#endif
+
+		/* SELECT .... statement (get rows from server) */
+		if (pttci->stmt_sign1 == 0 && pttci->stmt_sign2 == 0x04) {
+			pttci->direction_offset = tns_span_offset(&span);
+			pttci->data_direction = tns_span_get_guint8(&span);
+			pttci->unknown_4 = tns_span_get_guint8(&span);
+			pttci->unknown_5 = tns_span_get_ntohs(&span);
+		}
+		/* UPDATE / INSERT / DELETE?? .... statement (push data to server)
+			* -> offset increases 2 bytes */
+		else if (pttci->stmt_sign1 == 0 && pttci->stmt_sign2 == 0) {
+			tns_span_skip(&span, 2);
+			pttci->direction_offset = tns_span_offset(&span);
+			pttci->data_direction = tns_span_get_guint8(&span);
+			pttci->unknown_4 = tns_span_get_guint8(&span);
+			pttci->unknown_5 = tns_span_get_ntohs(&span);
+		}
+
+#ifdef _DISSECTOR_SQL_DEBUG
+		fprintf(stdout, "%s: TTCI(offset=0x%04x) data_direction=0x%02x unknown_4=0x%02x unknown_5=0x%04x\n",
+			__func__, tns_span_offset(&span), 
+			pttci->data_direction, 
+			pttci->unknown_4, 
+			pttci->unknown_5);
+#endif
+
+		/* should be 0x01 */
+		pttci->stmt_byte4 = tns_span_get_guint8(&span);
+
+		/* should be 0x01 == INSERT/UPDATE/DELETE? or 0x0a == SELECT */
+		pttci->stmt_flags = tns_span_get_guint8(&span);
+
+		/* INSERT/UPDATE/DELETE? parameter count */
+		tv_disp_offset = tns_span_offset(&span);
+		pttci->param_count = tns_span_get_guint8(&span);
+
+#ifdef _DISSECTOR_SQL_DEBUG
+		fprintf(stdout, "%s: TTCI(offset=0x%04x) stmt_byte4=0x%02x stmt_flags=0x%02x param_count=%d\n",
+			__func__, tns_span_offset(&span), pttci->stmt_byte4, pttci->stmt_flags, pttci->param_count);
+#endif
+
+		/* here on select statement a block of 0x7fff 0xffff follows */
+		pttci->unknown_6 = tns_span_get_ntohs(&span);
+		pttci->unknown_7 = tns_span_get_ntohs(&span);
+
+		/* parameter count SELECT -> display offset + 7 */
+		if ( pttci->stmt_flags == 0x0a )
+		{
+			/* should be 0x01 */
+			pttci->stmt_sel_unk1 = tns_span_get_guint8(&span);
+
+			/* should be 0x01 */
+			pttci->stmt_sel_unk2 = tns_span_get_guint8(&span);
+
+			tv_disp_offset = tns_span_offset(&span);
+			pttci->param_count = tns_span_get_guint8(&span);
+		}
+
+		pttci->param_count_offset = tv_disp_offset;
+		offset = tns_span_offset(&span);
+
+#ifdef _DISSECTOR_SQL_DEBUG
+		fprintf(stdout, "%s: TTCI(offset=0x%04x) unknown_6=0x%04x unknown_7=0x%04x stmt_sel_unk1=0x%02x stmt_sel_unk2=0x%02x\n",
+			__func__, tns_span_offset(&span), 
+			pttci->unknown_6, 
+			pttci->unknown_7,
+			pttci->stmt_sel_unk1,
+			pttci->stmt_sel_unk2);
+#endif
+	}
+
+	switch (pttci->data_direction)
+	{
+		case 0x7f: 
+		{
+			hdr_jmp_len = 15;
+			break;
+		}
+		case 0xff: 
+		{
+			hdr_jmp_len = 18;
+			break;
+		}
+		default:
+		{
+			fprintf(stderr, "%s: TTC/TTI: Invalid data direction type, abort.\n", __func__);
+			return offset;
+		}
+	}
+
+	/* set start offset of SQL statement */
+	offset += hdr_jmp_len;
+
+	/* get remaining bytes of packet buffer */
+	bytes_remaining = tvb_reported_length_remaining(tvb, offset);
+
+#ifdef _DISSECTOR_SQL_DEBUG
+	fprintf(stdout, "%s: TTCI(offset=0x%04x) SQL:STMT:START remaining=%d +++++++\n", 
+		__func__, offset, bytes_remaining);
+#endif
+
+	if ( !bytes_remaining ) 
+	{
+		return offset;
+	}
+
+	/* long statements (PL/SQL blocks) are sent in chunks, announced
+	 * by the marker in place of the length byte before the text */
+	if ( tvb_get_guint8(tvb, offset - 1) == TTCI_LONG_LENGTH_MARKER )
+	{
+		stmt_end = tns_walk_chunks(tvb, offset - 1, pttci->ttc_field_version, &chunked_length, NULL);
+		if ( stmt_end >= 0 )
+		{
+			pttci->stmt_offset = offset - 1;
+			pttci->stmt_length = chunked_length;
+			pttci->stmt_chunked = TRUE;
+
+#ifdef _DISSECTOR_SQL_DEBUG
+			fprintf(stdout, "%s: TTCI(offset=0x%04x) SQL:STMT:END chunked stmt_length=%d +++++++\n", 
+				__func__, stmt_end, chunked_length);
+#endif
+			return stmt_end;
+		}
+	}
+
+	/* end of SQL statement: searched in place, so the cost depends on
+	 * the statement length and not on the bind data that follows */
+	stmt_end = tns_find_pattern(tvb, offset, -1, ttci_stmt_terminator, sizeof(ttci_stmt_terminator));
+	if (stmt_end >= 0)
+	{
+		stmt_length = stmt_end - offset;
+	}
+
+	/* SQL statement found and without embedded NUL? */
+	if (stmt_end < 0 || tvb_find_guint8(tvb, offset, stmt_length, 0) != -1)
+	{
+		fprintf(stderr, "%s: TTC/TTI:SQL statement length mismatch. Abort!\n", __func__);
+		return offset;
+	}
+
+	pttci->stmt_offset = offset;
+	pttci->stmt_length = stmt_length;
+
+#ifdef _DISSECTOR_SQL_DEBUG
+	fprintf(stdout, "%s: TTCI(offset=0x%04x) SQL:STMT:END stmt_length=%d +++++++\n", 
+		__func__, offset + stmt_length + 1, stmt_length);
+#endif
+
+	return offset + stmt_length;
+}
+
+/* TCC/TCI Parse SQL statement packet */
+static int dissect_tns_data_sql(tvbuff_t *tvb, packet_info *pinfo, proto_tree *data_tree, int offset, ttci_packet_t* pttci)
+{
+	tns_pdu_info_t *pdu_info;
+	ttci_packet_t *record;
+	proto_item *pi;
+	gboolean want_binds;
+
+	/* bind decoding is the expensive part, skip it if nobody asks for it */
+	want_binds = tns_fields_referenced(data_tree, ttci_bind_hf_list, array_length(ttci_bind_hf_list));
 
-				byte_buffer = tvb_memcpy(tvb, byte_buffer, offset, value_len);
-				byte_buffer[value_len + 1] = 0;
+	/*
+	 * The first pass stores what it has parsed with the frame, later
+	 * passes (GUI selection, refiltering) only rebuild the tree from the
+	 * recorded offsets. A record is extended if a later pass needs the
+	 * binds that have not been asked for before.
+	 */
+	pdu_info = tns_get_pdu_info(pinfo);
+	record = pdu_info->ttci;
+	if ( !record )
+	{
+		record = wmem_new(wmem_file_scope(), ttci_packet_t);
+		*record = *pttci;
+		record->end_offset = dissect_tns_data_sql_stmt(tvb, offset, record);
+		pdu_info->ttci = record;
+	}
 
-#ifdef _DISSECTOR_SQL_DEBUG
-				fprintf(stderr, "%s: TTCI(offset=0x%04x) STRING VALUE: %s\n", 
-					__func__, offset, byte_buffer);
-#endif
+	if ( want_binds && record->parse_state == TTCI_PARSED_STMT )
+	{
+		record->parse_state = TTCI_PARSED_BINDS;
+		if ( record->stmt_length > 0 )
+		{
+			/* SQL parameter descriptor block follows after SQL statement */
+			record->end_offset = dissect_tns_data_sql_params(tvb, pinfo,
+				record->stmt_chunked ? record->end_offset : record->stmt_offset + record->stmt_length, record);
+		}
+	}
+
+	*pttci = *record;
+
+	if ( pttci->oall8_decoded )
+	{
+		ttci_oall8_hdr_t hdr = {};
+
+		ttci_decode_oall8(tvb, data_tree, pttci->oall8_offset, pttci->ttc_field_version, &hdr);
+		pi = proto_tree_add_uint(data_tree, hf_tns_data_ttic_data_direction, tvb, 0, 0, pttci->data_direction);
+		proto_item_set_generated(pi);
+	}
+	if ( pttci->unknown_3_offset >= 0 )
+	{
+		proto_tree_add_item(data_tree, hf_tns_data_ttic_pkt_unknown_3, tvb, pttci->unknown_3_offset, 2, ENC_BIG_ENDIAN);
+	}
+	if ( pttci->direction_offset >= 0 )
+	{
+		proto_tree_add_item(data_tree, hf_tns_data_ttic_data_direction, tvb, pttci->direction_offset, 1, ENC_BIG_ENDIAN);
+	}
+	if ( pttci->param_count_offset >= 0 )
+	{
+		proto_tree_add_item(data_tree, hf_tns_data_ttic_param_count, tvb, pttci->param_count_offset, 1, ENC_BIG_ENDIAN);
+	}
+	if ( pttci->stmt_length > 0 )
+	{
+		tvbuff_t *stmt_tvb = tvb;
+		int stmt_offset = pttci->stmt_offset;
+		const tns_sql_t *statement;
+
+		if ( pttci->stmt_chunked )
+		{
+			/* reassembled from the chunks, the marker selects all of them */
+			stmt_tvb = tns_chunked_value_tvb(tvb, pinfo, pttci->stmt_offset, pttci->ttc_field_version, "SQL Statement");
+			stmt_offset = 0;
+		}
+
+		/* add statement to tree view, backed by the tvb */
+		proto_tree_add_item(data_tree, hf_tns_data_ttic_stmt_sql, stmt_tvb, stmt_offset, pttci->stmt_length, ENC_UTF_8);
+
+		statement = tns_intern_sql(pinfo, (const gchar *) tvb_get_string_enc(pinfo->pool, stmt_tvb,
+			stmt_offset, pttci->stmt_length, ENC_UTF_8));
+		pi = proto_tree_add_uint64(data_tree, hf_tns_sql_fingerprint, stmt_tvb, stmt_offset, pttci->stmt_length,
+			statement->fingerprint);
+		proto_item_append_text(pi, " (%s)", statement->normalized);
+		proto_item_set_generated(pi);
+		if ( statement->verb )
+		{
+			pi = proto_tree_add_string(data_tree, hf_tns_sql_verb, stmt_tvb, stmt_offset, pttci->stmt_length,
+				statement->verb);
+			proto_item_set_generated(pi);
+		}
+	}
+
+	if ( want_binds )
+	{
+		dissect_tns_data_sql_binds(tvb, pinfo, data_tree, pttci);
+	}
+
+	return pttci->end_offset;
+}
+
+/*
+ * TTC messages larger than the SDU are sent as a sequence of Data packets
+ * filled up to the SDU size, the last one being shorter. Some clients set
+ * the "more data" flag instead. The parts are collected per conversation
+ * (the reassembly key holds the direction) and the complete message is
+ * returned once, built by the reassembly code in a single concatenation.
+ * Returns NULL for a part that does not complete a message.
+ *
+ * A full packet does not tell whether the message ends with it, the
+ * message is held open until the next Data packet. If the peer sends one
+ * first, the message ended at an SDU boundary, see tns_finish_ttc().
+ */
+static tvbuff_t *tns_reassemble_ttc(tvbuff_t *tvb, int offset, packet_info *pinfo, proto_tree *tree,
+				    tns_conv_info_t *tns_info, guint16 data_flags, gboolean is_request)
+{
+	tns_pdu_info_t *pdu_info;
+	fragment_head *fd_head;
+	tvbuff_t *ttc_tvb;
+	guint32 id;
+	gint length;
+
+	length = tvb_reported_length_remaining(tvb, offset);
+	if ( length <= 0 || !tvb_bytes_exist(tvb, offset, length) )
+	{
+		return tvb;
+	}
+
+	id = find_or_create_conversation(pinfo)->conv_index;
+
+	/* decided on the first pass, the conversation state is final later */
+	if ( !PINFO_FD_VISITED(pinfo) )
+	{
+		tns_ttc_open_t *open = &tns_info->ttc_open[is_request ? 0 : 1];
+		gboolean more;
+
+		more = (data_flags & TNS_DATA_FLAG_MORE) ||
+		       (tns_info->sdu_size != 0 && tvb_reported_length(tvb) >= tns_info->sdu_size);
+
+		if ( more || open->pdu_info )
+		{
+			pdu_info = tns_get_pdu_info(pinfo);
+			pdu_info->ttc_fragment = TRUE;
+			pdu_info->ttc_more = more;
+			open->pdu_info = more ? pdu_info : NULL;
+			open->fd = pinfo->fd;
+			open->abs_ts = pinfo->abs_ts;
+			open->pdu_key = tns_pdu_key(pinfo);
+			open->layer_num = pinfo->curr_layer_num;
+		}
+	}
+
+	pdu_info = tns_find_pdu_info(pinfo);
+	if ( !pdu_info || !pdu_info->ttc_fragment )
+	{
+		return tvb;
+	}
+
+	fd_head = fragment_add_seq_next(&tns_ttc_reassembly_table, tvb, offset, pinfo, id, NULL,
+					length, pdu_info->ttc_more);
+	ttc_tvb = process_reassembled_data(tvb, offset, pinfo, "Reassembled TTC", fd_head,
+					   &tns_ttc_frag_items, NULL, tree);
+	if ( !ttc_tvb )
+	{
+		col_append_str(pinfo->cinfo, COL_INFO, " (TTC fragment)");
+		call_data_dissector(tvb_new_subset_remaining(tvb, offset), pinfo, tree);
+	}
+
+	return ttc_tvb;
+}
+
+/* TTC functions of a Data packet or of a reassembled TTC message */
+static void dissect_tns_ttc(tvbuff_t *tvb, int offset, packet_info *pinfo, proto_tree *data_tree,
+			    tns_conv_info_t *tns_info, gboolean is_request)
+{
+	guint data_func_id;
+	guint oci_func_id = 0;
+	int ttci_offset;
+	const gchar *call_sql = NULL;
+	guint piggyback_closes = 0;
+	
+	ttci_packet_t ttci_packet = {};
+
+	/* piggybacked functions are followed by the call they are sent with */
+	for (;;)
+	{
+		int next_func_offset = -1;
+
+		/* state of a single call, a following one starts over */
+		memset(&ttci_packet, 0, sizeof(ttci_packet));
+		oci_func_id = 0;
+		call_sql = NULL;
 
-				/* selection focus value incl. length byte */
-				pi = proto_tree_add_item(pd_tree, (*hf_prop_ref), tvb, offset - 1, (gint) strlen(byte_buffer) + 1, ENC_UTF_8);
-				proto_item_set_text(pi, "%02d String: %s", param_idx + 1, (const char*) byte_buffer);
-				offset += value_len;
+		data_func_id = get_data_func_id(tvb, offset);
+
+		/* Do this only if the Data message have a body. Otherwise, there are only Data flags. */
+		if ( tvb_reported_length_remaining(tvb, offset) > 0 )
+		{
+			col_append_fstr(pinfo->cinfo, COL_INFO, ", %s", val_to_str_const(data_func_id, tns_data_funcs, "TNS: unknown"));
 
-				free(byte_buffer);
+			if ( (data_func_id != SQLNET_SNS) && (try_val_to_str(data_func_id, tns_data_funcs) != NULL) )
+			{
+				proto_tree_add_item(data_tree, hf_tns_data_id, tvb, offset, 1, ENC_BIG_ENDIAN);
+				offset += 1;
 			}
-			/* NUMBER or DATE or TIME or etc. */
-			else 
+		}
+
+		/* Handle data functions that have more than just ID */
+		switch (data_func_id)
+		{
+			case SQLNET_SET_PROTOCOL:
 			{
-				memset(numbuf, 0, sizeof(numbuf));
+				proto_tree *versions_tree;
+				proto_item *ti;
+				char sep;
+				if ( is_request )
+				{
+					versions_tree = proto_tree_add_subtree(data_tree, tvb, offset, -1, ett_tns_acc_versions, &ti, "Accepted Versions");
+					sep = ':';
+					for (;;) {
+						/*
+						 * Add each accepted version as a
+						 * separate item.
+						 */
+						guint8 vers;
+
+						vers = tvb_get_guint8(tvb, offset);
+						if (vers == 0) {
+							/*
+							 * A version of 0 terminates
+							 * the list.
+							 */
+							break;
+						}
+						proto_item_append_text(ti, "%c %u", sep, vers);
+						sep = ',';
+						proto_tree_add_uint(versions_tree, hf_tns_data_setp_acc_version, tvb, offset, 1, vers);
+						offset += 1;
+					}
+					offset += 1; /* skip the 0 terminator */
+					proto_item_set_end(ti, tvb, offset);
+					proto_tree_add_item(data_tree, hf_tns_data_setp_cli_plat, tvb, offset, -1, ENC_ASCII);
+
+					return; /* skip call_data_dissector */
+				}
+				else
+				{
+					gint len;
+					versions_tree = proto_tree_add_subtree(data_tree, tvb, offset, -1, ett_tns_acc_versions, &ti, "Versions");
+					sep = ':';
+					for (;;) {
+						/*
+						 * Add each version as a separate item.
+						 */
+						guint8 vers;
+
+						vers = tvb_get_guint8(tvb, offset);
+						if (vers == 0) {
+							/*
+							 * A version of 0 terminates
+							 * the list.
+							 */
+							break;
+						}
+						/* the first one is the version the server talks */
+						if ( !PINFO_FD_VISITED(pinfo) && sep == ':' )
+						{
+							tns_info->ttc_version = vers;
+						}
+						proto_item_append_text(ti, "%c %u", sep, vers);
+						sep = ',';
+						proto_tree_add_uint(versions_tree, hf_tns_data_setp_version, tvb, offset, 1, vers);
+						offset += 1;
+					}
+					offset += 1; /* skip the 0 terminator */
+					proto_item_set_end(ti, tvb, offset);
+					proto_tree_add_item_ret_length(data_tree, hf_tns_data_setp_banner, tvb, offset, -1, ENC_ASCII|ENC_NA, &len);
+					offset += len;
+				}
+				break;
+			}
 
-				/* flags:
-				 * 0x16 => 0001 0110 --> pu1=0x0000 | pu2=0x0000 [VL=1 -> pm3=0x0007 or VL=2 -> pm3=0x0001]
-				 * 0x07 => 0000 0111 --> pu1=0x0000 | pu2=0x0000
-				 * 0x01 => 0000 0001 --> pu1=0x0b00 | pu2=0x0004 (date/time)
+			case SQLNET_SET_DATATYPES:
+			{
+				/*
+				 * Client request: charset (2), ncharset (2), encoding flags (1),
+				 * then the length prefixed compile time capabilities that carry
+				 * the TTC field version used for the rest of the session.
 				 */
-				#if 0
-				bool isLE = false;
-				double value = 0.0f;
-				switch (value_len)
+				if ( is_request && tvb_bytes_exist(tvb, offset, 6) )
 				{
-					/* 8bit */
-					case 1:
-						value = tvb_get_gint8(tvb, offset);
-						break;
-					/* 16bit */
-					case 2:
-						value = (isLE ? tvb_get_letohis(tvb, offset) : tvb_get_ntohis(tvb, offset));
-						break;
-					/* 24bit */
-					case 3:
-						value = (isLE ? tvb_get_letohi24(tvb, offset) : tvb_get_ntoh24(tvb, offset));
-						break;
-					/* 32bit */
-					case 4:
-						value = (isLE ? tvb_get_letohil(tvb, offset) : tvb_get_ntohil(tvb, offset));
-						break;
-					/* 40bit */
-					case 5:
-						value = (isLE ? tvb_get_letohi40(tvb, offset) : tvb_get_ntohi40(tvb, offset));
-						break;
-					/* 48bit */
-					case 6:
-						value = (isLE ? tvb_get_letohi48(tvb, offset) : tvb_get_ntohi48(tvb, offset));
-						break;
-					/* 56bit */
-					case 7:
-						value = (isLE ? tvb_get_letohi56(tvb, offset) : tvb_get_ntohi56(tvb, offset));
-						break;
-					/* 64bit */
-					case 8:
-						value = (isLE ? tvb_get_letohi64(tvb, offset) : tvb_get_ntohi64(tvb, offset));
-						break;
-					/* others */
-					default:
-						/* DATE / TIME VALUE */
-						if ((pd_list[param_idx].param_props.unknown_1 == 0x0b00) &&
-						    (pd_list[param_idx].param_props.unknown_2 & 0x0004)) 
+					guint8 ccap_len = tvb_get_guint8(tvb, offset + 5);
+
+					if ( ccap_len > TTC_CCAP_FIELD_VERSION &&
+					     tvb_bytes_exist(tvb, offset + 6 + TTC_CCAP_FIELD_VERSION, 1) )
+					{
+						guint32 field_version;
+
+						proto_tree_add_item_ret_uint(data_tree, hf_tns_data_sdty_ttc_field_version, tvb,
+							offset + 6 + TTC_CCAP_FIELD_VERSION, 1, ENC_NA, &field_version);
+
+						if ( !PINFO_FD_VISITED(pinfo) )
 						{
-							/* date / time */
-							strcpy(numbuf, "<value not translated>");
-						} 
-						else 
+							tns_info->ttc_field_version = field_version;
+						}
+					}
+				}
+				break;
+			}
+
+			case SQLNET_USER_OCI_FUNC:
+				if ( tvb_reported_length_remaining(tvb, offset) > 0 )
+				{
+					proto_tree_add_item_ret_uint(data_tree, hf_tns_data_oci_id, tvb, offset, 1, ENC_BIG_ENDIAN, &oci_func_id);
+					offset += 1;
+				}
+
+				/* TTC/TTI START ===================================================================== */
+
+				ttci_offset = offset;
+				if ( tvb_reported_length_remaining(tvb, offset) > 3 )
+				{
+					ttci_packet.packet_number = tvb_get_guint8(tvb, offset);
+					proto_tree_add_item(data_tree, hf_tns_data_ttic_pkt_number, tvb, offset, 1, ENC_BIG_ENDIAN);
+					offset += 1;
+
+					ttci_packet.unknown_1 = tvb_get_guint16(tvb, offset, ENC_BIG_ENDIAN);
+					proto_tree_add_item(data_tree, hf_tns_data_ttic_pkt_unknown_1, tvb, offset, 2, ENC_BIG_ENDIAN);
+					offset += 2;
+
+					ttci_packet.ttc_field_version = tns_info->ttc_field_version;
+					ttci_packet.oall8_offset = oci_func_id == SQLNET_USER_FUNC_OALL8 ? ttci_offset : -1;
+					ttci_packet.request_type = tvb_get_guint8(tvb, offset);
+					proto_tree_add_item(data_tree, hf_tns_data_ttic_req_type, tvb, offset, 1, ENC_BIG_ENDIAN);
+					offset += 1;
+	#ifdef _DISSECTOR_SQL_DEBUG
+					fprintf(stdout, "%s: TTCI(offset=0x%04x) number=%d type=0x%02x u1=0x%04x (%d)\n",
+						__func__, offset, 
+						ttci_packet.packet_number, 
+						ttci_packet.request_type, 
+						ttci_packet.unknown_1, 
+						ttci_packet.unknown_1);
+	#endif
+				}
+			
+				switch(ttci_packet.request_type)
+				{
+					case SQLNET_TTCI_REQ_SQLSTMT: 
+					{
+	#ifdef _DISSECTOR_SQL_DEBUG
+						fprintf(stdout, "%s: TTCI(offset=0x%04x) ======================= START ============================\n",
+							__func__, offset);
+	#endif
+						/* statement and binds are only parsed on behalf of a
+						 * filter, column or tree that references their fields,
+						 * and on the first pass to fill the cursor table */
+						if ( !PINFO_FD_VISITED(pinfo) ||
+						     tns_fields_referenced(data_tree, ttci_stmt_hf_list, array_length(ttci_stmt_hf_list)) ||
+						     tns_fields_referenced(data_tree, ttci_bind_hf_list, array_length(ttci_bind_hf_list)) )
 						{
-							value = tvb_get_ntohieee_double(tvb, offset);
+							offset = dissect_tns_data_sql(tvb, pinfo, data_tree, offset, &ttci_packet);
 						}
 						break;
+					}
 				}
-				if (strlen(numbuf) == 0) 
+
+				/* user name and client identity of the authentication calls */
+				if ( is_request && (oci_func_id == SQLNET_USER_FUNC_GETSESSKEY || oci_func_id == SQLNET_USER_FUNC_AUTH) )
 				{
-					snprintf(numbuf, 127, "%f", value);
+					tns_auth_request(tvb, pinfo, data_tree, ttci_offset, tns_info);
 				}
-				#endif
-				
-				char *p = &numbuf[0];
-				for(int j=0; j < value_len && j < (int)(sizeof(numbuf)/4); j++) {
-					sprintf(p, "%02x ", tvb_get_guint8(tvb, offset + j));
-					p += 3;
+
+				/* cursor of OALL8 and fetch calls */
+				if ( is_request && (oci_func_id == SQLNET_USER_FUNC_OALL8 || oci_func_id == SQLNET_USER_FUNC_OFETCH) )
+				{
+					guint32 cursor_id;
+					int cursor_offset, len;
+
+					cursor_offset = tns_fetch_request(tvb, data_tree, ttci_offset, oci_func_id,
+						tns_info->ttc_field_version, &ttci_packet);
+					len = cursor_offset < 0 ? 0 : tns_get_ttc_ub4(tvb, cursor_offset, &cursor_id);
+
+					/* (re)parse, the call sends the statement text. Later passes
+					 * show the cursor like a plain execute, its statement is
+					 * only looked up for those on the first pass. */
+					if ( len > 0 && oci_func_id == SQLNET_USER_FUNC_OALL8 && !PINFO_FD_VISITED(pinfo) &&
+					     ttci_packet.request_type == SQLNET_TTCI_REQ_SQLSTMT && ttci_packet.stmt_length > 0 )
+					{
+						tvbuff_t *stmt_tvb = tvb;
+						int stmt_offset = ttci_packet.stmt_offset;
+						const tns_sql_t *statement;
+						const gchar *sql;
+
+						if ( ttci_packet.stmt_chunked )
+						{
+							stmt_tvb = tns_chunked_value_tvb(tvb, pinfo, stmt_offset, ttci_packet.ttc_field_version, NULL);
+							stmt_offset = 0;
+						}
+						statement = tns_intern_sql(pinfo, (const gchar *) tvb_get_string_enc(pinfo->pool, stmt_tvb,
+							stmt_offset, ttci_packet.stmt_length, ENC_UTF_8));
+						sql = statement->text;
+
+						call_sql = sql;
+
+						/* keyed by the fingerprint of the file scope statement */
+						ttci_packet.parse_count = GPOINTER_TO_UINT(wmem_map_lookup(tns_info->parses, &statement->fingerprint)) + 1;
+						wmem_map_insert(tns_info->parses, (gpointer) &statement->fingerprint, GUINT_TO_POINTER(ttci_packet.parse_count));
+
+						/* new cursors get their id with the response */
+						if ( cursor_id == 0 )
+						{
+							tns_info->pending_sql = sql;
+							tns_info->pending_frame = pinfo->num;
+						}
+						else
+						{
+							tns_cursor_open(tns_info, cursor_id, sql, pinfo->num);
+							proto_tree_add_uint(data_tree, hf_tns_data_cursor_id, tvb, cursor_offset, len, cursor_id);
+						}
+					}
+					else if ( len > 0 && cursor_id != 0 )
+					{
+						call_sql = tns_cursor_add_item(tvb, pinfo, data_tree, cursor_offset, len, tns_info, cursor_id);
+					}
 				}
 
-				/* selection focus value incl. length byte */
-				pi = proto_tree_add_item(pd_tree, (*hf_prop_ref), tvb, offset - 1, value_len + 1, ENC_UTF_8);
-				if ((pd_list[param_idx].param_props.unknown_1 == 0x0b00) &&
-					(pd_list[param_idx].param_props.unknown_2 & 0x0004)) 
+				/* TTC/TTI END ==============================================================================*/
+				break;
+
+			case SQLNET_RETURN_OPI_PARAM:
+			{
+				guint8 skip = 0, opi = 0;
+
+				if ( tvb_bytes_exist(tvb, offset, 11) )
 				{
-#ifdef _DISSECTOR_SQL_DEBUG
-					fprintf(stderr, "%s: TTCI(offset=0x%04x) DATE/TIME(%d) VALUE: %s\n", 
-							__func__, offset, value_len, numbuf);
-#endif
-					proto_item_set_text(pi, "%02d Date/Time (Hex Bytes): %s", param_idx + 1, (const char*) numbuf);
+					/*
+					 * OPI_VERSION2 response has a following pattern:
+					 *
+					 *                _ banner      _ vsnum
+					 *               /             /
+					 *    ..(.?)(Orac[le.+])(.?)(....).+$
+					 *     |
+					 *     \ banner length (if equal to 0 then next byte indicates the length).
+					 *
+					 * These differences (to skip 1 or 2 bytes) due to differences in the drivers.
+					 */
+					                                  /* Orac[le.+] */
+					if ( tvb_get_ntohl(tvb, offset+2) == 0x4f726163 )
+					{
+						opi = OPI_VERSION2;
+						skip = 1;
+					}
+
+					else if ( tvb_get_ntohl(tvb, offset+3) == 0x4f726163 )
+					{
+						opi = OPI_VERSION2;
+						skip = 2;
+					}
+
+					/*
+					 * OPI_OSESSKEY response has a following pattern:
+					 *
+					 *               _ pattern (v1|v2)
+					 *              /        _ params
+					 *             /        /
+					 *    (....)(........)(.+).+$
+					 *       ||
+					 *        \ if these two bytes are equal to 0x0c00 then first byte is <Param Counts> (v1),
+					 *          else next byte indicate it (v2).
+					 */
+					                                          /*  ....AUTH (v1) */
+					else if ( tvb_get_ntoh64(tvb, offset+3) == 0x0000000c41555448 )
+					{
+						opi = OPI_OSESSKEY;
+						skip = 1;
+					}
+					                                          /*  ..AUTH_V (v2) */
+					else if ( tvb_get_ntoh64(tvb, offset+3) == 0x0c0c415554485f53 )
+					{
+						opi = OPI_OSESSKEY;
+						skip = 2;
+					}
+
+					/*
+					 * OPI_OAUTH response has a following pattern:
+					 *
+					 *               _ pattern (v1|v2)
+					 *              /        _ params
+					 *             /        /
+					 *    (....)(........)(.+).+$
+					 *       ||
+					 *        \ if these two bytes are equal to 0x1300 then first byte is <Param Counts> (v1),
+					 *          else next byte indicate it (v2).
+					 */
+
+					                                          /*  ....AUTH (v1) */
+					else if ( tvb_get_ntoh64(tvb, offset+3) == 0x0000001341555448 )
+					{
+						opi = OPI_OAUTH;
+						skip = 1;
+					}
+				                                                  /*  ..AUTH_V (v2) */
+					else if ( tvb_get_ntoh64(tvb, offset+3) == 0x1313415554485f56 )
+					{
+						opi = OPI_OAUTH;
+						skip = 2;
+					}
 				}
-				else 
+
+				if ( opi == OPI_VERSION2 )
 				{
-#ifdef _DISSECTOR_SQL_DEBUG
-					fprintf(stderr, "%s: TTCI(offset=0x%04x) NUMBER(%d) VALUE: %s\n", 
-							__func__, offset, value_len, numbuf);
-#endif
-					proto_item_set_text(pi, "%02d Number (Hex Bytes): %s", param_idx + 1, (const char*) numbuf);
+					proto_tree_add_item(data_tree, hf_tns_data_unused, tvb, offset, skip, ENC_NA);
+					offset += skip;
+
+					guint8 len = tvb_get_guint8(tvb, offset);
+
+					proto_tree_add_item(data_tree, hf_tns_data_opi_version2_banner_len, tvb, offset, 1, ENC_BIG_ENDIAN);
+					offset += 1;
+
+					proto_tree_add_item(data_tree, hf_tns_data_opi_version2_banner, tvb, offset, len, ENC_ASCII);
+					offset += len + (skip == 1 ? 1 : 0);
+
+					proto_tree_add_item(data_tree, hf_tns_data_opi_version2_vsnum, tvb, offset, 4, (skip == 1) ? ENC_BIG_ENDIAN : ENC_LITTLE_ENDIAN);
+					offset += 4;
 				}
-				offset += value_len;
-			}
-		}
-	
-exit_clenup_list:
-		free(pd_list);
+				else if ( opi == OPI_OSESSKEY || opi == OPI_OAUTH )
+				{
+					proto_tree *params_tree;
+					proto_item *params_ti;
+					guint par, params;
+
+					if ( skip == 1 )
+					{
+						proto_tree_add_item_ret_uint(data_tree, hf_tns_data_opi_num_of_params, tvb, offset, 1, ENC_NA, &params);
+						offset += 1;
 
-exit_cleanup:
-		free(pd_header);
-	} 
+						proto_tree_add_item(data_tree, hf_tns_data_unused, tvb, offset, 5, ENC_NA);
+						offset += 5;
+					}
+					else
+					{
+						proto_tree_add_item(data_tree, hf_tns_data_unused, tvb, offset, 1, ENC_NA);
+						offset += 1;
 
-exit_done:
-#ifdef _DISSECTOR_SQL_DEBUG
-	fprintf(stdout, "%s: TTCI(offset=0x%04x) SQL:PARAMS:END --------\n", 
-		__func__, offset);
-#endif
+						proto_tree_add_item_ret_uint(data_tree, hf_tns_data_opi_num_of_params, tvb, offset, 1, ENC_NA, &params);
+						offset += 1;
 
-	return offset;
-}
+						proto_tree_add_item(data_tree, hf_tns_data_unused, tvb, offset, 2, ENC_NA);
+						offset += 2;
+					}
 
-/* TCC/TCI Parse SQL statement packet */
-static int dissect_tns_data_sql(tvbuff_t *tvb, proto_tree *data_tree, int offset, ttci_packet_t* pttci)
-{
-	proto_item *pi;
-	uint8_t* byte_buffer;
-	gint stmt_length = 0;
-	int bytes_remaining;
-	int tv_disp_offset = -1;
-	int hdr_jmp_len;
+					params_tree = proto_tree_add_subtree(data_tree, tvb, offset, -1, ett_tns_opi_params, &params_ti, "Parameters");
 
-	if ( tvb_reported_length_remaining(tvb, offset) > 19 )
-	{
-		pttci->unknown_2 = tvb_get_guint16(tvb, offset, ENC_BIG_ENDIAN);
-		offset += 2;
+					for ( par = 1; par <= params; par++ )
+					{
+						proto_tree *par_tree;
+						proto_item *par_ti;
+						guint len, offset_prev;
+						int name_offset = -1, name_len = 0;
 
-		pttci->unknown_3 = tvb_get_guint16(tvb, offset, ENC_BIG_ENDIAN);
-		proto_tree_add_item(data_tree, hf_tns_data_ttic_pkt_unknown_3, tvb, offset, 2, ENC_BIG_ENDIAN);
-		offset += 2;
+						par_tree = proto_tree_add_subtree(params_tree, tvb, offset, -1, ett_tns_opi_par, &par_ti, "Parameter");
+						proto_item_append_text(par_ti, " %u", par);
 
-#ifdef _DISSECTOR_SQL_DEBUG
-		fprintf(stdout, "%s: TTCI(offset=0x%04x) unknown_2=0x%04x unknown_3=0x%04x (%d)\n",
-			__func__, offset, 
-			pttci->unknown_2, 
-			pttci->unknown_3,
-			pttci->unknown_3);
-#endif
+						/* Name length */
+						proto_tree_add_item_ret_uint(par_tree, hf_tns_data_opi_param_length, tvb, offset, 1, ENC_NA, &len);
+						offset += 1;
 
-		/* should be 0x01 or 0x33 or 0x35 */
-		pttci->stmt_byte1 = tvb_get_guint8(tvb, offset);
-		offset += 1;
-		
-		/* offset increased one step */
-		if (pttci->stmt_byte1 != 0x01) {
-			pttci->stmt_byte1_prfx = pttci->stmt_byte1;
-			/* should be 0x01 */
-			pttci->stmt_byte1 = tvb_get_guint8(tvb, offset);
-			offset += 1;
-		}
+						/* Name */
+						if ( !(len == 0 || len == 2) ) /* Not empty (2 - SQLDeveloper specific sign). */
+						{
+							proto_tree_add_item(par_tree, hf_tns_data_opi_param_name, tvb, offset, len, ENC_ASCII);
+							name_offset = offset;
+							name_len = len;
+							offset += len;
+						}
 
-		/* should be 0x01 */
-		pttci->stmt_byte2 = tvb_get_guint8(tvb, offset);
-		offset += 1;
+						/* Value can be NULL. So, save offset to calculate unused data. */
+						offset_prev = offset;
+						offset += skip == 1 ? 4 : 2;
 
-		/* should be 0x0d */
-		pttci->stmt_byte3 = tvb_get_guint8(tvb, offset);
-		offset += 1;
+						/* Value length */
+						if ( opi == OPI_OSESSKEY )
+						{
+							len = tvb_get_guint8(tvb, offset);
+						}
+						else /* OPI_OAUTH */
+						{
+							len = tvb_get_guint8(tvb, offset_prev) == 0 ? 0 : tvb_get_guint8(tvb, offset);
+						}
 
-#ifdef _DISSECTOR_SQL_DEBUG
-		fprintf(stdout, "%s: TTCI(offset=0x%04x) prfx=0x%02x stmt_byte1=0x%02x stmt_byte2=0x%02x stmt_byte3=0x%02x\n", 
-			__func__, offset, 
-			pttci->stmt_byte1_prfx, 
-			pttci->stmt_byte1, 
-			pttci->stmt_byte2, 
-			pttci->stmt_byte3);
-#endif
+						/*
+						 * Value
+						 *   OPI_OSESSKEY: AUTH_VFR_DATA with length 0, 9, 0x39 comes without data.
+						 *   OPI_OAUTH: AUTH_VFR_DATA with length 0, 0x39 comes without data.
+						 */
+						if ( ((opi == OPI_OSESSKEY) && !(len == 0 || len == 9 || len == 0x39))
+						  || ((opi == OPI_OAUTH) && !(len == 0 || len == 0x39)) )
+						{
+							proto_tree_add_item(par_tree, hf_tns_data_unused, tvb, offset_prev, offset - offset_prev, ENC_NA);
 
-		/* should be 0x0000 */
-		pttci->stmt_sign1 = tvb_get_guint16(tvb, offset, ENC_BIG_ENDIAN);
-		offset += 2;
+							proto_tree_add_item(par_tree, hf_tns_data_opi_param_length, tvb, offset, 1, ENC_NA);
+							offset += 1;
 
-		/* should be 0x04 */
-		pttci->stmt_sign2 = tvb_get_guint8(tvb, offset);
-		offset += 1;
+							proto_tree_add_item(par_tree, hf_tns_data_opi_param_value, tvb, offset, len, ENC_ASCII);
+							tns_session_set_param(pinfo, tns_info, tvb, name_offset, name_len, offset, len);
+							offset += len;
 
-#ifdef _DISSECTOR_SQL_DEBUG		
-		fprintf(stdout, "%s: TTCI(offset=0x%04x) stmt_sign1=0x%04x stmt_sign2=0x%02x\n",
-			__func__, offset, 
-			pttci->stmt_sign1, 
-			pttci->stmt_sign2);
-#endif
+							offset_prev = offset; /* Save offset to calculate rest of unused data */
+						}
+						else
+						{
+							offset += 1;
+						}
 
-		/* SELECT .... statement (get rows from server) */
-		if (pttci->stmt_sign1 == 0 && pttci->stmt_sign2 == 0x04) {
-			pttci->data_direction = tvb_get_guint8(tvb, offset);
-			proto_tree_add_item(data_tree, hf_tns_data_ttic_data_direction, tvb, offset, 1, ENC_BIG_ENDIAN);
-			offset += 1;
-			pttci->unknown_4 = tvb_get_guint8(tvb, offset);
-			offset += 1;
-			pttci->unknown_5 = tvb_get_guint16(tvb, offset, ENC_BIG_ENDIAN);
-			offset += 2;
-		}
-		/* UPDATE / INSERT / DELETE?? .... statement (push data to server)
-			* -> offset increases 2 bytes */
-		else if (pttci->stmt_sign1 == 0 && pttci->stmt_sign2 == 0) {
-			offset += 2;
-			pttci->data_direction = tvb_get_guint8(tvb, offset);
-			proto_tree_add_item(data_tree, hf_tns_data_ttic_data_direction, tvb, offset, 1, ENC_BIG_ENDIAN);
-			offset += 1;
-			pttci->unknown_4 = tvb_get_guint8(tvb, offset);
-			offset += 1;
-			pttci->unknown_5 = tvb_get_guint16(tvb, offset, ENC_BIG_ENDIAN);
-			offset += 2;
-		}
+						if ( opi == OPI_OSESSKEY )
+						{
+							/* SQL Developer specifix fix */
+							offset += tvb_get_guint8(tvb, offset) == 2 ? 5 : 3;
+						}
+						else /* OPI_OAUTH */
+						{
+							offset += len == 0 ? 1 : 3;
+						}
 
-#ifdef _DISSECTOR_SQL_DEBUG
-		fprintf(stdout, "%s: TTCI(offset=0x%04x) data_direction=0x%02x unknown_4=0x%02x unknown_5=0x%04x\n",
-			__func__, offset, 
-			pttci->data_direction, 
-			pttci->unknown_4, 
-			pttci->unknown_5);
-#endif
+						if ( skip == 1 )
+						{
+							offset += 1 + ((len == 0 || len == 0x39) ? 3 : 4);
 
-		/* should be 0x01 */
-		pttci->stmt_byte4 = tvb_get_guint8(tvb, offset);
-		offset += 1;
+							if ( opi == OPI_OAUTH )
+							{
+								offset += len == 0 ? 2 : 0;
+							}
+						}
 
-		/* should be 0x01 == INSERT/UPDATE/DELETE? or 0x0a == SELECT */
-		pttci->stmt_flags = tvb_get_guint8(tvb, offset);
-		offset += 1;
+						proto_tree_add_item(par_tree, hf_tns_data_unused, tvb, offset_prev, offset - offset_prev, ENC_NA);
+						proto_item_set_end(par_ti, tvb, offset);
+					}
+					proto_item_set_end(params_ti, tvb, offset);
+				}
+				else if ( !is_request )
+				{
+					/* RPA of a bundled call */
+					tns_cursor_response(tvb, pinfo, data_tree, offset, tns_info, data_func_id);
+				}
+				break;
+			}
 
-		/* INSERT/UPDATE/DELETE? parameter count */
-		pttci->param_count = tvb_get_guint8(tvb, offset);
-		tv_disp_offset = offset;
-		offset += 1;
+			case SQLNET_RETURN_STATUS:
+				if ( !is_request )
+				{
+					tns_cursor_response(tvb, pinfo, data_tree, offset, tns_info, data_func_id);
+				}
+				break;
 
-#ifdef _DISSECTOR_SQL_DEBUG
-		fprintf(stdout, "%s: TTCI(offset=0x%04x) stmt_byte4=0x%02x stmt_flags=0x%02x param_count=%d\n",
-			__func__, offset, pttci->stmt_byte4, pttci->stmt_flags, pttci->param_count);
-#endif
+			case SQLNET_DESCRIBE_INFO:
+			case SQLNET_ROW_TRANSF_HDR:
+			case SQLNET_ROW_TRANSF_DATA:
+			case SQLNET_BIT_VECTOR:
+				if ( !is_request )
+				{
+					tns_fetch_response(tvb, pinfo, data_tree, offset, tns_info, data_func_id);
+				}
+				break;
 
-		/* here on select statement a block of 0x7fff 0xffff follows */
-		pttci->unknown_6 = tvb_get_guint16(tvb, offset, ENC_BIG_ENDIAN);
-		offset += 2;
-		pttci->unknown_7 = tvb_get_guint16(tvb, offset, ENC_BIG_ENDIAN);
-		offset += 2;
+			case SQLNET_PIGGYBACK_FUNC:
+			{
+				guint32 piggyback_id;
 
-		/* parameter count SELECT -> display offset + 7 */
-		if ( pttci->stmt_flags == 0x0a )
-		{
-			/* should be 0x01 */
-			pttci->stmt_sel_unk1 = tvb_get_guint8(tvb, offset);
-			offset += 1;
+				proto_tree_add_item_ret_uint(data_tree, hf_tns_data_piggyback_id, tvb, offset, 1, ENC_BIG_ENDIAN, &piggyback_id);
+				offset += 1;
 
-			/* should be 0x01 */
-			pttci->stmt_sel_unk2 = tvb_get_guint8(tvb, offset);
-			offset += 1;
+				/* close cursors: sequence (1), pointer (1), count (ub4), cursor ids (ub4) */
+				if ( piggyback_id == SQLNET_USER_FUNC_OCCA && tvb_bytes_exist(tvb, offset, 2) )
+				{
+					guint32 count, cursor_id;
+					int cursor_offset, len;
 
-			pttci->param_count = tvb_get_guint8(tvb, offset);
-			tv_disp_offset = offset;
-			offset += 1;
-		}
+					cursor_offset = offset + 2;
+					len = tns_get_ttc_ub4(tvb, cursor_offset, &count);
+					for (guint32 i = 0; len > 0 && i < count; i++)
+					{
+						cursor_offset += len;
+						len = tns_get_ttc_ub4(tvb, cursor_offset, &cursor_id);
+						if ( len == 0 )
+							break;
+
+						tns_cursor_add_item(tvb, pinfo, data_tree, cursor_offset, len, tns_info, cursor_id);
+						proto_tree_add_uint(data_tree, hf_tns_data_cursor_closed, tvb, cursor_offset, len, cursor_id);
+						if ( !PINFO_FD_VISITED(pinfo) )
+						{
+							tns_cursor_close(tns_info, cursor_id);
+						}
+						piggyback_closes++;
+					}
 
-		proto_tree_add_item(data_tree, hf_tns_data_ttic_param_count, tvb, tv_disp_offset, 1, ENC_BIG_ENDIAN);
+					/* the call the closes are piggybacked on follows, it
+					 * makes the round trip */
+					if ( len > 0 && is_request &&
+					     tvb_bytes_exist(tvb, cursor_offset + len, 1) &&
+					     tvb_get_guint8(tvb, cursor_offset + len) == SQLNET_USER_OCI_FUNC )
+					{
+						next_func_offset = cursor_offset + len;
+					}
+				}
+				break;
+			}
 
-#ifdef _DISSECTOR_SQL_DEBUG
-		fprintf(stdout, "%s: TTCI(offset=0x%04x) unknown_6=0x%04x unknown_7=0x%04x stmt_sel_unk1=0x%02x stmt_sel_unk2=0x%02x\n",
-			__func__, offset, 
-			pttci->unknown_6, 
-			pttci->unknown_7,
-			pttci->stmt_sel_unk1,
-			pttci->stmt_sel_unk2);
-#endif
-	}
+			case SQLNET_SNS:
+			{
+				proto_tree_add_item(data_tree, hf_tns_data_id, tvb, offset, 4, ENC_BIG_ENDIAN);
+				offset += 4;
 
-	switch (pttci->data_direction)
-	{
-		case 0x7f: 
-		{
-			hdr_jmp_len = 15;
-			break;
+				proto_tree_add_item(data_tree, hf_tns_data_length, tvb, offset, 2, ENC_BIG_ENDIAN);
+				offset += 2;
+
+				if ( is_request )
+				{
+					proto_tree_add_item(data_tree, hf_tns_data_sns_cli_vers, tvb, offset, 4, ENC_BIG_ENDIAN);
+				}
+				else
+				{
+					proto_tree_add_item(data_tree, hf_tns_data_sns_srv_vers, tvb, offset, 4, ENC_BIG_ENDIAN);
+				}
+				offset += 4;
+
+				proto_tree_add_item(data_tree, hf_tns_data_sns_srvcnt, tvb, offset, 2, ENC_BIG_ENDIAN);
+
+				/* move back, to include data_id into data_dissector */
+				offset -= 10;
+				break;
+			}
 		}
-		case 0xff: 
+
+		if ( next_func_offset < 0 )
 		{
-			hdr_jmp_len = 18;
 			break;
 		}
-		default:
-		{
-			fprintf(stderr, "%s: TTC/TTI: Invalid data direction type, abort.\n", __func__);
-			return offset;
-		}
+		offset = next_func_offset;
 	}
 
-	/* set start offset of SQL statement */
-	offset += hdr_jmp_len;
-
-	/* get remaining bytes of packet buffer */
-	bytes_remaining = tvb_reported_length_remaining(tvb, offset);
-
-#ifdef _DISSECTOR_SQL_DEBUG
-	fprintf(stdout, "%s: TTCI(offset=0x%04x) SQL:STMT:START remaining=%d +++++++\n", 
-		__func__, offset, bytes_remaining);
-#endif
-
-	if ( !bytes_remaining ) 
+	/* calls are OCI functions, answered by whatever the server sends next */
+	if ( tvb_reported_length_remaining(tvb, offset) > 0 &&
+	     (data_func_id == SQLNET_USER_OCI_FUNC || !is_request) )
 	{
-		return offset;
+		tns_match_call(tvb, pinfo, data_tree, tns_info, is_request, oci_func_id, &ttci_packet, call_sql, piggyback_closes);
 	}
 
-	/* allocate SQL statement buffer */
-	if (!(byte_buffer = malloc(bytes_remaining + 1)))
+	/* a pending cursor id is only expected in the next response */
+	if ( !is_request && !PINFO_FD_VISITED(pinfo) )
 	{
-		fprintf(stderr, "%s: TTC/TTI: Out of memory. Abort!\n", __func__);
-		return offset;
+		tns_info->pending_sql = NULL;
 	}
-	memset(byte_buffer, 0, bytes_remaining + 1);
 
-#ifdef _DISSECTOR_SQL_DEBUG
-	fprintf(stdout, "%s: TTCI(offset=0x%04x) buffer_size=%d\n",
-		__func__, offset, bytes_remaining + 1);
-#endif
+	call_data_dissector(tvb_new_subset_remaining(tvb, offset), pinfo, data_tree);
+}
+
+/*
+ * First pass: a TTC message held open in the direction given, since its
+ * last part filled the SDU, ended with that part when the peer sends a
+ * Data packet. Its reassembly is closed with fragment_end_seq_next() as
+ * of the frame of the last part, where later passes show it, and the
+ * first pass state of the message (calls, cursors, pending statement) is
+ * built now by dissecting it without a tree on behalf of that frame,
+ * before the answer is dissected.
+ */
+static void tns_finish_ttc(packet_info *pinfo, tns_conv_info_t *tns_info, gboolean is_request)
+{
+	tns_ttc_open_t *open = &tns_info->ttc_open[is_request ? 0 : 1];
+	packet_info *last_pinfo;
+	frame_data *last_fd;
+	fragment_head *fd_head;
 
-	/* copy SQL statement from packet stream */
-	byte_buffer = (uint8_t*) tvb_memcpy(tvb, byte_buffer, offset, bytes_remaining);
-	for (int i = 0; i < bytes_remaining; i++) 
+	if ( !open->pdu_info )
 	{
-		/* check end of SQL statement */
-		if (byte_buffer[i] == 0x01 && byte_buffer[i+1] == 0x01) 
-		{
-			stmt_length = i;
-			byte_buffer[i] = 0; // terminate
-			break;
-		}
+		return;
 	}
-	
-	/* SQL statement loaded? */
-	if (stmt_length != (gint) strlen((const char*) byte_buffer))
+
+	/* packet info of the last part, its frame record is copied back */
+	last_fd = wmem_new(pinfo->pool, frame_data);
+	*last_fd = *open->fd;
+	last_fd->visited = 0;
+
+	last_pinfo = wmem_new(pinfo->pool, packet_info);
+	*last_pinfo = *pinfo;
+	last_pinfo->fd = last_fd;
+	last_pinfo->num = last_fd->num;
+	last_pinfo->abs_ts = open->abs_ts;
+	last_pinfo->curr_layer_num = open->layer_num;
+	last_pinfo->cinfo = NULL;
+	last_pinfo->proto_data = NULL;
+	copy_address_shallow(&last_pinfo->src, &pinfo->dst);
+	copy_address_shallow(&last_pinfo->dst, &pinfo->src);
+	last_pinfo->srcport = pinfo->destport;
+	last_pinfo->destport = pinfo->srcport;
+	p_add_proto_data(last_pinfo->pool, last_pinfo, proto_tns, TNS_PROTO_DATA_PDU_COUNT, GUINT_TO_POINTER(open->pdu_key + 1));
+
+	open->pdu_info->ttc_more = FALSE;
+	open->pdu_info = NULL;
+
+	fd_head = fragment_end_seq_next(&tns_ttc_reassembly_table, last_pinfo,
+					find_or_create_conversation(last_pinfo)->conv_index, NULL);
+	if ( fd_head && fd_head->tvb_data )
 	{
-		fprintf(stderr, "%s: TTC/TTI:SQL statement length mismatch. Abort!\n", __func__);
-		free(byte_buffer);
-		return offset;
+		dissect_tns_ttc(fd_head->tvb_data, 0, last_pinfo, NULL, tns_info, is_request);
 	}
 
-#ifdef _DISSECTOR_SQL_DEBUG
-	fprintf(stdout, "%s: TTCI(offset=0x%04x) len=%d stmt=%s\n", 
-		__func__, offset, stmt_length, byte_buffer);
-#endif		
-
-	/* add statement to tree view */	
-	pi = proto_tree_add_item(data_tree, hf_tns_data_ttic_stmt_sql, tvb, offset, stmt_length, ENC_UTF_8);
-	proto_item_set_text(pi, "%s", (const char*) byte_buffer);
-
-	free(byte_buffer);
-
-#ifdef _DISSECTOR_SQL_DEBUG
-	fprintf(stdout, "%s: TTCI(offset=0x%04x) SQL:STMT:END stmt_length=%d +++++++\n", 
-		__func__, offset + stmt_length + 1, stmt_length);
-#endif
-
-	/* SQL parameter descriptor block follows after SQL statement */
-	return dissect_tns_data_sql_params(tvb, data_tree, offset + stmt_length, pttci);
+	open->fd->pfd = last_fd->pfd;
 }
 
-static void dissect_tns_data(tvbuff_t *tvb, int offset, packet_info *pinfo, proto_tree *tns_tree)
+static void dissect_tns_data(tvbuff_t *tvb, int offset, packet_info *pinfo, proto_tree *tns_tree, tns_conv_info_t *tns_info)
 {
 	proto_tree *data_tree;
-	guint data_func_id;
+	guint16 data_flags;
 	gboolean is_request;
-	
-	ttci_packet_t ttci_packet = {};
 
 	static int * const flags[] = {
 		&hf_tns_data_flag_send,
@@ -1500,390 +5686,254 @@ static void dissect_tns_data(tvbuff_t *tvb, int offset, packet_info *pinfo, prot
 		NULL
 	};
 
-	is_request = pinfo->match_uint == pinfo->destport;
+	is_request = tns_is_request(pinfo, tns_info);
 	data_tree = proto_tree_add_subtree(tns_tree, tvb, offset, -1, ett_tns_data, NULL, "Data");
 
+	data_flags = tvb_get_ntohs(tvb, offset);
 	proto_tree_add_bitmask(data_tree, tvb, offset, hf_tns_data_flag, ett_tns_data_flag, flags, ENC_BIG_ENDIAN);
 	offset += 2;
-	data_func_id = get_data_func_id(tvb, offset);
 
-	/* Do this only if the Data message have a body. Otherwise, there are only Data flags. */
-	if ( tvb_reported_length_remaining(tvb, offset) > 0 )
+	if ( tns_ttc_reassemble )
 	{
-		col_append_fstr(pinfo->cinfo, COL_INFO, ", %s", val_to_str_const(data_func_id, tns_data_funcs, "TNS: unknown"));
+		tvbuff_t *ttc_tvb;
 
-		if ( (data_func_id != SQLNET_SNS) && (try_val_to_str(data_func_id, tns_data_funcs) != NULL) )
+		/* a Data packet from the peer ends the message held open */
+		if ( !PINFO_FD_VISITED(pinfo) )
 		{
-			proto_tree_add_item(data_tree, hf_tns_data_id, tvb, offset, 1, ENC_BIG_ENDIAN);
-			offset += 1;
+			tns_finish_ttc(pinfo, tns_info, !is_request);
 		}
-	}
-
-	/* Handle data functions that have more than just ID */
-	switch (data_func_id)
-	{
-		case SQLNET_SET_PROTOCOL:
-		{
-			proto_tree *versions_tree;
-			proto_item *ti;
-			char sep;
-			if ( is_request )
-			{
-				versions_tree = proto_tree_add_subtree(data_tree, tvb, offset, -1, ett_tns_acc_versions, &ti, "Accepted Versions");
-				sep = ':';
-				for (;;) {
-					/*
-					 * Add each accepted version as a
-					 * separate item.
-					 */
-					guint8 vers;
-
-					vers = tvb_get_guint8(tvb, offset);
-					if (vers == 0) {
-						/*
-						 * A version of 0 terminates
-						 * the list.
-						 */
-						break;
-					}
-					proto_item_append_text(ti, "%c %u", sep, vers);
-					sep = ',';
-					proto_tree_add_uint(versions_tree, hf_tns_data_setp_acc_version, tvb, offset, 1, vers);
-					offset += 1;
-				}
-				offset += 1; /* skip the 0 terminator */
-				proto_item_set_end(ti, tvb, offset);
-				proto_tree_add_item(data_tree, hf_tns_data_setp_cli_plat, tvb, offset, -1, ENC_ASCII);
 
-				return; /* skip call_data_dissector */
-			}
-			else
-			{
-				gint len;
-				versions_tree = proto_tree_add_subtree(data_tree, tvb, offset, -1, ett_tns_acc_versions, &ti, "Versions");
-				sep = ':';
-				for (;;) {
-					/*
-					 * Add each version as a separate item.
-					 */
-					guint8 vers;
+		ttc_tvb = tns_reassemble_ttc(tvb, offset, pinfo, data_tree, tns_info, data_flags, is_request);
 
-					vers = tvb_get_guint8(tvb, offset);
-					if (vers == 0) {
-						/*
-						 * A version of 0 terminates
-						 * the list.
-						 */
-						break;
-					}
-					proto_item_append_text(ti, "%c %u", sep, vers);
-					sep = ',';
-					proto_tree_add_uint(versions_tree, hf_tns_data_setp_version, tvb, offset, 1, vers);
-					offset += 1;
-				}
-				offset += 1; /* skip the 0 terminator */
-				proto_item_set_end(ti, tvb, offset);
-				proto_tree_add_item_ret_length(data_tree, hf_tns_data_setp_banner, tvb, offset, -1, ENC_ASCII|ENC_NA, &len);
-				offset += len;
-			}
-			break;
+		if ( !ttc_tvb )
+		{
+			return;
 		}
-
-		case SQLNET_USER_OCI_FUNC:
-			if ( tvb_reported_length_remaining(tvb, offset) > 0 )
-			{
-				proto_tree_add_item(data_tree, hf_tns_data_oci_id, tvb, offset, 1, ENC_BIG_ENDIAN);
-				offset += 1;
-			}
-
-			/* TTC/TTI START ===================================================================== */
-
-			if ( tvb_reported_length_remaining(tvb, offset) > 3 )
-			{
-				ttci_packet.packet_number = tvb_get_guint8(tvb, offset);
-				proto_tree_add_item(data_tree, hf_tns_data_ttic_pkt_number, tvb, offset, 1, ENC_BIG_ENDIAN);
-				offset += 1;
-
-				ttci_packet.unknown_1 = tvb_get_guint16(tvb, offset, ENC_BIG_ENDIAN);
-				proto_tree_add_item(data_tree, hf_tns_data_ttic_pkt_unknown_1, tvb, offset, 2, ENC_BIG_ENDIAN);
-				offset += 2;
-
-				ttci_packet.request_type = tvb_get_guint8(tvb, offset);
-				proto_tree_add_item(data_tree, hf_tns_data_ttic_req_type, tvb, offset, 1, ENC_BIG_ENDIAN);
-				offset += 1;
-#ifdef _DISSECTOR_SQL_DEBUG
-				fprintf(stdout, "%s: TTCI(offset=0x%04x) number=%d type=0x%02x u1=0x%04x (%d)\n",
-					__func__, offset, 
-					ttci_packet.packet_number, 
-					ttci_packet.request_type, 
-					ttci_packet.unknown_1, 
-					ttci_packet.unknown_1);
-#endif
-			}
-			
-			switch(ttci_packet.request_type)
-			{
-				case SQLNET_TTCI_REQ_SQLSTMT: 
-				{
-#ifdef _DISSECTOR_SQL_DEBUG
-					fprintf(stdout, "%s: TTCI(offset=0x%04x) ======================= START ============================\n",
-						__func__, offset);
-#endif
-					offset = dissect_tns_data_sql(tvb, data_tree, offset, &ttci_packet);
-					break;
-				}
-			}
-
-			/* TTC/TTI END ==============================================================================*/
-			break;
-
-		case SQLNET_RETURN_OPI_PARAM:
+		if ( ttc_tvb != tvb )
 		{
-			guint8 skip = 0, opi = 0;
-
-			if ( tvb_bytes_exist(tvb, offset, 11) )
-			{
-				/*
-				 * OPI_VERSION2 response has a following pattern:
-				 *
-				 *                _ banner      _ vsnum
-				 *               /             /
-				 *    ..(.?)(Orac[le.+])(.?)(....).+$
-				 *     |
-				 *     \ banner length (if equal to 0 then next byte indicates the length).
-				 *
-				 * These differences (to skip 1 or 2 bytes) due to differences in the drivers.
-				 */
-				                                  /* Orac[le.+] */
-				if ( tvb_get_ntohl(tvb, offset+2) == 0x4f726163 )
-				{
-					opi = OPI_VERSION2;
-					skip = 1;
-				}
-
-				else if ( tvb_get_ntohl(tvb, offset+3) == 0x4f726163 )
-				{
-					opi = OPI_VERSION2;
-					skip = 2;
-				}
-
-				/*
-				 * OPI_OSESSKEY response has a following pattern:
-				 *
-				 *               _ pattern (v1|v2)
-				 *              /        _ params
-				 *             /        /
-				 *    (....)(........)(.+).+$
-				 *       ||
-				 *        \ if these two bytes are equal to 0x0c00 then first byte is <Param Counts> (v1),
-				 *          else next byte indicate it (v2).
-				 */
-				                                          /*  ....AUTH (v1) */
-				else if ( tvb_get_ntoh64(tvb, offset+3) == 0x0000000c41555448 )
-				{
-					opi = OPI_OSESSKEY;
-					skip = 1;
-				}
-				                                          /*  ..AUTH_V (v2) */
-				else if ( tvb_get_ntoh64(tvb, offset+3) == 0x0c0c415554485f53 )
-				{
-					opi = OPI_OSESSKEY;
-					skip = 2;
-				}
-
-				/*
-				 * OPI_OAUTH response has a following pattern:
-				 *
-				 *               _ pattern (v1|v2)
-				 *              /        _ params
-				 *             /        /
-				 *    (....)(........)(.+).+$
-				 *       ||
-				 *        \ if these two bytes are equal to 0x1300 then first byte is <Param Counts> (v1),
-				 *          else next byte indicate it (v2).
-				 */
-
-				                                          /*  ....AUTH (v1) */
-				else if ( tvb_get_ntoh64(tvb, offset+3) == 0x0000001341555448 )
-				{
-					opi = OPI_OAUTH;
-					skip = 1;
-				}
-			                                                  /*  ..AUTH_V (v2) */
-				else if ( tvb_get_ntoh64(tvb, offset+3) == 0x1313415554485f56 )
-				{
-					opi = OPI_OAUTH;
-					skip = 2;
-				}
-			}
-
-			if ( opi == OPI_VERSION2 )
-			{
-				proto_tree_add_item(data_tree, hf_tns_data_unused, tvb, offset, skip, ENC_NA);
-				offset += skip;
-
-				guint8 len = tvb_get_guint8(tvb, offset);
-
-				proto_tree_add_item(data_tree, hf_tns_data_opi_version2_banner_len, tvb, offset, 1, ENC_BIG_ENDIAN);
-				offset += 1;
+			tvb = ttc_tvb;
+			offset = 0;
+		}
+	}
 
-				proto_tree_add_item(data_tree, hf_tns_data_opi_version2_banner, tvb, offset, len, ENC_ASCII);
-				offset += len + (skip == 1 ? 1 : 0);
+	dissect_tns_ttc(tvb, offset, pinfo, data_tree, tns_info, is_request);
+}
 
-				proto_tree_add_item(data_tree, hf_tns_data_opi_version2_vsnum, tvb, offset, 4, (skip == 1) ? ENC_BIG_ENDIAN : ENC_LITTLE_ENDIAN);
-				offset += 4;
-			}
-			else if ( opi == OPI_OSESSKEY || opi == OPI_OAUTH )
-			{
-				proto_tree *params_tree;
-				proto_item *params_ti;
-				guint par, params;
+/*
+ * Connect descriptor keys of the session values, with the key of the
+ * enclosing list, e.g. (CONNECT_DATA=(SERVICE_NAME=..)(CID=(PROGRAM=..)))
+ */
+static const struct {
+	const gchar *parent;
+	const gchar *key;
+	int *hf;
+} tns_cd_keys[TNS_CD_COUNT] = {
+	[TNS_CD_SERVICE_NAME] = { "CONNECT_DATA", "SERVICE_NAME", &hf_tns_connect_service_name },
+	[TNS_CD_SID]          = { "CONNECT_DATA", "SID",          &hf_tns_connect_sid },
+	[TNS_CD_CID]          = { "CONNECT_DATA", "CID",          &hf_tns_connect_cid },
+	[TNS_CD_PROGRAM]      = { "CID",          "PROGRAM",      &hf_tns_connect_program },
+	[TNS_CD_HOST]         = { "CID",          "HOST",         &hf_tns_connect_host },
+	[TNS_CD_USER]         = { "CID",          "USER",         &hf_tns_connect_user },
+};
 
-				if ( skip == 1 )
-				{
-					proto_tree_add_item_ret_uint(data_tree, hf_tns_data_opi_num_of_params, tvb, offset, 1, ENC_NA, &params);
-					offset += 1;
+/* Deepest nesting of a connect descriptor that is parsed */
+#define TNS_CD_MAX_DEPTH 16
 
-					proto_tree_add_item(data_tree, hf_tns_data_unused, tvb, offset, 5, ENC_NA);
-					offset += 5;
-				}
-				else
-				{
-					proto_tree_add_item(data_tree, hf_tns_data_unused, tvb, offset, 1, ENC_NA);
-					offset += 1;
+/* Location of a value in the connect descriptor */
+typedef struct {
+	gint pos;       /* -1 if not present */
+	gint len;
+} tns_cd_value_t;
 
-					proto_tree_add_item_ret_uint(data_tree, hf_tns_data_opi_num_of_params, tvb, offset, 1, ENC_NA, &params);
-					offset += 1;
+/* Trim blanks around cd[*pos .. *pos + *len) */
+static void tns_cd_trim(const guint8 *cd, gint *pos, gint *len)
+{
+	while (*len > 0 && g_ascii_isspace(cd[*pos]))
+	{
+		(*pos)++;
+		(*len)--;
+	}
+	while (*len > 0 && g_ascii_isspace(cd[*pos + *len - 1]))
+		(*len)--;
+}
 
-					proto_tree_add_item(data_tree, hf_tns_data_unused, tvb, offset, 2, ENC_NA);
-					offset += 2;
-				}
+static gboolean tns_cd_key_equal(const guint8 *cd, gint pos, gint len, const gchar *key)
+{
+	return (size_t) len == strlen(key) && g_ascii_strncasecmp((const gchar *) cd + pos, key, len) == 0;
+}
 
-				params_tree = proto_tree_add_subtree(data_tree, tvb, offset, -1, ett_tns_opi_params, &params_ti, "Parameters");
+/*
+ * Locate the session values in a connect descriptor, in a single pass
+ * and without allocations. The descriptor is a nesting of (KEY=value)
+ * pairs where a value is either text or a list of pairs. Each pair is
+ * pushed on '(' and its value recorded on the closing ')'. Backslash
+ * escapes and double quoted text are skipped. The first occurrence of
+ * each key wins.
+ */
+static void tns_parse_connect_descriptor(const guint8 *cd, gint cd_len, tns_cd_value_t *values)
+{
+	struct {
+		gint key_pos, key_len;
+		gint value_pos;     /* -1 while in the key */
+		gint field;         /* TNS_CD_xxx, -1 if not of interest */
+	} stack[TNS_CD_MAX_DEPTH];
+	gint depth = 0;
+	gboolean quoted = FALSE;
 
-				for ( par = 1; par <= params; par++ )
-				{
-					proto_tree *par_tree;
-					proto_item *par_ti;
-					guint len, offset_prev;
+	for (int i = 0; i < TNS_CD_COUNT; i++)
+		values[i].pos = -1;
 
-					par_tree = proto_tree_add_subtree(params_tree, tvb, offset, -1, ett_tns_opi_par, &par_ti, "Parameter");
-					proto_item_append_text(par_ti, " %u", par);
+	for (gint pos = 0; pos < cd_len; pos++)
+	{
+		guint8 c = cd[pos];
 
-					/* Name length */
-					proto_tree_add_item_ret_uint(par_tree, hf_tns_data_opi_param_length, tvb, offset, 1, ENC_NA, &len);
-					offset += 1;
+		if (c == '\\')
+		{
+			pos++;
+			continue;
+		}
+		if (c == '"')
+		{
+			quoted = !quoted;
+			continue;
+		}
+		if (quoted)
+			continue;
 
-					/* Name */
-					if ( !(len == 0 || len == 2) ) /* Not empty (2 - SQLDeveloper specific sign). */
-					{
-						proto_tree_add_item(par_tree, hf_tns_data_opi_param_name, tvb, offset, len, ENC_ASCII);
-						offset += len;
-					}
+		if (c == '(')
+		{
+			if (depth == TNS_CD_MAX_DEPTH)
+				return;
+			stack[depth].key_pos = pos + 1;
+			stack[depth].key_len = 0;
+			stack[depth].value_pos = -1;
+			stack[depth].field = -1;
+			depth++;
+		}
+		else if (c == '=' && depth > 0 && stack[depth - 1].value_pos < 0)
+		{
+			gint key_pos = stack[depth - 1].key_pos;
+			gint key_len = pos - key_pos;
 
-					/* Value can be NULL. So, save offset to calculate unused data. */
-					offset_prev = offset;
-					offset += skip == 1 ? 4 : 2;
+			tns_cd_trim(cd, &key_pos, &key_len);
+			stack[depth - 1].key_pos = key_pos;
+			stack[depth - 1].key_len = key_len;
+			stack[depth - 1].value_pos = pos + 1;
 
-					/* Value length */
-					if ( opi == OPI_OSESSKEY )
-					{
-						len = tvb_get_guint8(tvb, offset);
-					}
-					else /* OPI_OAUTH */
-					{
-						len = tvb_get_guint8(tvb, offset_prev) == 0 ? 0 : tvb_get_guint8(tvb, offset);
-					}
+			if (depth < 2)
+				continue;
 
-					/*
-					 * Value
-					 *   OPI_OSESSKEY: AUTH_VFR_DATA with length 0, 9, 0x39 comes without data.
-					 *   OPI_OAUTH: AUTH_VFR_DATA with length 0, 0x39 comes without data.
-					 */
-					if ( ((opi == OPI_OSESSKEY) && !(len == 0 || len == 9 || len == 0x39))
-					  || ((opi == OPI_OAUTH) && !(len == 0 || len == 0x39)) )
-					{
-						proto_tree_add_item(par_tree, hf_tns_data_unused, tvb, offset_prev, offset - offset_prev, ENC_NA);
+			for (int i = 0; i < TNS_CD_COUNT; i++)
+			{
+				if (tns_cd_key_equal(cd, key_pos, key_len, tns_cd_keys[i].key) &&
+				    tns_cd_key_equal(cd, stack[depth - 2].key_pos, stack[depth - 2].key_len, tns_cd_keys[i].parent))
+				{
+					stack[depth - 1].field = i;
+					break;
+				}
+			}
+		}
+		else if (c == ')' && depth > 0)
+		{
+			depth--;
+			if (stack[depth].field >= 0 && values[stack[depth].field].pos < 0)
+			{
+				gint value_pos = stack[depth].value_pos;
+				gint value_len = pos - value_pos;
 
-						proto_tree_add_item(par_tree, hf_tns_data_opi_param_length, tvb, offset, 1, ENC_NA);
-						offset += 1;
+				tns_cd_trim(cd, &value_pos, &value_len);
+				if (value_len > 0)
+				{
+					values[stack[depth].field].pos = value_pos;
+					values[stack[depth].field].len = value_len;
+				}
+			}
+		}
+	}
+}
 
-						proto_tree_add_item(par_tree, hf_tns_data_opi_param_value, tvb, offset, len, ENC_ASCII);
-						offset += len;
+/* Connect descriptor values of the connect data at offset, kept on the first pass */
+static void tns_add_connect_descriptor(tvbuff_t *tvb, int offset, gint len, packet_info *pinfo,
+				       proto_tree *tree, tns_conv_info_t *tns_info)
+{
+	tns_cd_value_t values[TNS_CD_COUNT];
+	const guint8 *cd;
 
-						offset_prev = offset; /* Save offset to calculate rest of unused data */
-					}
-					else
-					{
-						offset += 1;
-					}
+	len = MIN(len, tvb_captured_length_remaining(tvb, offset));
+	if ( len <= 0 )
+		return;
 
-					if ( opi == OPI_OSESSKEY )
-					{
-						/* SQL Developer specifix fix */
-						offset += tvb_get_guint8(tvb, offset) == 2 ? 5 : 3;
-					}
-					else /* OPI_OAUTH */
-					{
-						offset += len == 0 ? 1 : 3;
-					}
+	cd = tvb_get_ptr(tvb, offset, len);
+	tns_parse_connect_descriptor(cd, len, values);
 
-					if ( skip == 1 )
-					{
-						offset += 1 + ((len == 0 || len == 0x39) ? 3 : 4);
+	for (int i = 0; i < TNS_CD_COUNT; i++)
+	{
+		if ( values[i].pos < 0 )
+			continue;
 
-						if ( opi == OPI_OAUTH )
-						{
-							offset += len == 0 ? 2 : 0;
-						}
-					}
+		proto_tree_add_item(tree, *tns_cd_keys[i].hf, tvb,
+			offset+values[i].pos, values[i].len, ENC_ASCII);
 
-					proto_tree_add_item(par_tree, hf_tns_data_unused, tvb, offset_prev, offset - offset_prev, ENC_NA);
-					proto_item_set_end(par_ti, tvb, offset);
-				}
-				proto_item_set_end(params_ti, tvb, offset);
-			}
-			break;
+		if ( !PINFO_FD_VISITED(pinfo) )
+		{
+			tns_info->connect_values[i] = (const gchar *) tvb_get_string_enc(wmem_file_scope(), tvb,
+				offset+values[i].pos, values[i].len, ENC_ASCII);
 		}
+	}
+}
 
-		case SQLNET_PIGGYBACK_FUNC:
-			proto_tree_add_item(data_tree, hf_tns_data_piggyback_id, tvb, offset, 1, ENC_BIG_ENDIAN);
-			offset += 1;
-			break;
+/* Session values of the Connect, on every other packet of the session */
+static void tns_add_connect_values(tvbuff_t *tvb, proto_tree *tns_tree, const tns_conv_info_t *tns_info)
+{
+	proto_item *pi;
 
-		case SQLNET_SNS:
+	for (int i = 0; i < TNS_CD_COUNT; i++)
+	{
+		if (tns_info->connect_values[i])
 		{
-			proto_tree_add_item(data_tree, hf_tns_data_id, tvb, offset, 4, ENC_BIG_ENDIAN);
-			offset += 4;
+			pi = proto_tree_add_string(tns_tree, *tns_cd_keys[i].hf, tvb, 0, 0, tns_info->connect_values[i]);
+			proto_item_set_generated(pi);
+		}
+	}
+}
 
-			proto_tree_add_item(data_tree, hf_tns_data_length, tvb, offset, 2, ENC_BIG_ENDIAN);
-			offset += 2;
+/* Session identity as of the frame, on every packet of the session */
+static void tns_add_session_values(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tns_tree, const tns_conv_info_t *tns_info)
+{
+	const gchar *const *values;
+	proto_item *pi;
+	guint32 number;
 
-			if ( is_request )
-			{
-				proto_tree_add_item(data_tree, hf_tns_data_sns_cli_vers, tvb, offset, 4, ENC_BIG_ENDIAN);
-			}
-			else
-			{
-				proto_tree_add_item(data_tree, hf_tns_data_sns_srv_vers, tvb, offset, 4, ENC_BIG_ENDIAN);
-			}
-			offset += 4;
+	values = tns_session_values(pinfo, tns_info);
+	if ( !values )
+		return;
 
-			proto_tree_add_item(data_tree, hf_tns_data_sns_srvcnt, tvb, offset, 2, ENC_BIG_ENDIAN);
+	for (int i = 0; i < TNS_SESSION_COUNT; i++)
+	{
+		const gchar *value = values[i];
 
-			/* move back, to include data_id into data_dissector */
-			offset -= 10;
-			break;
+		if (!value)
+			continue;
+
+		if (tns_session_keys[i].numeric)
+		{
+			if (!ws_strtou32(value, NULL, &number))
+				continue;
+			pi = proto_tree_add_uint(tns_tree, *tns_session_keys[i].hf, tvb, 0, 0, number);
 		}
+		else
+		{
+			pi = proto_tree_add_string(tns_tree, *tns_session_keys[i].hf, tvb, 0, 0, value);
+		}
+		proto_item_set_generated(pi);
 	}
-
-	call_data_dissector(tvb_new_subset_remaining(tvb, offset), pinfo, data_tree);
 }
 
-static void dissect_tns_connect(tvbuff_t *tvb, int offset, packet_info *pinfo _U_, proto_tree *tns_tree)
+static void dissect_tns_connect(tvbuff_t *tvb, int offset, packet_info *pinfo, proto_tree *tns_tree, tns_conv_info_t *tns_info)
 {
 	proto_tree *connect_tree;
 	guint32 cd_offset, cd_len;
+	guint32 version, sdu_size, tdu_size;
 	int tns_offset = offset-8;
 	static int * const flags[] = {
 		&hf_tns_ntp_flag_hangon,
@@ -1908,8 +5958,8 @@ static void dissect_tns_connect(tvbuff_t *tvb, int offset, packet_info *pinfo _U
 	connect_tree = proto_tree_add_subtree(tns_tree, tvb, offset, -1,
 		ett_tns_connect, NULL, "Connect");
 
-	proto_tree_add_item(connect_tree, hf_tns_version, tvb,
-			offset, 2, ENC_BIG_ENDIAN);
+	proto_tree_add_item_ret_uint(connect_tree, hf_tns_version, tvb,
+			offset, 2, ENC_BIG_ENDIAN, &version);
 	offset += 2;
 
 	proto_tree_add_item(connect_tree, hf_tns_compat_version, tvb,
@@ -1919,14 +5969,23 @@ static void dissect_tns_connect(tvbuff_t *tvb, int offset, packet_info *pinfo _U
 	proto_tree_add_bitmask(connect_tree, tvb, offset, hf_tns_service_options, ett_tns_sopt_flag, tns_service_options, ENC_BIG_ENDIAN);
 	offset += 2;
 
-	proto_tree_add_item(connect_tree, hf_tns_sdu_size, tvb,
-			offset, 2, ENC_BIG_ENDIAN);
+	proto_tree_add_item_ret_uint(connect_tree, hf_tns_sdu_size, tvb,
+			offset, 2, ENC_BIG_ENDIAN, &sdu_size);
 	offset += 2;
 
-	proto_tree_add_item(connect_tree, hf_tns_max_tdu_size, tvb,
-			offset, 2, ENC_BIG_ENDIAN);
+	proto_tree_add_item_ret_uint(connect_tree, hf_tns_max_tdu_size, tvb,
+			offset, 2, ENC_BIG_ENDIAN, &tdu_size);
 	offset += 2;
 
+	/* requested values, replaced by the Accept */
+	if ( !PINFO_FD_VISITED(pinfo) && tns_info->accept_frame == 0 )
+	{
+		tns_info->connect_frame = pinfo->num;
+		tns_info->version = version;
+		tns_info->sdu_size = sdu_size;
+		tns_info->tdu_size = tdu_size;
+	}
+
 	proto_tree_add_bitmask(connect_tree, tvb, offset, hf_tns_nt_proto_characteristics, ett_tns_ntp_flag, flags, ENC_BIG_ENDIAN);
 	offset += 2;
 
@@ -1977,35 +6036,94 @@ static void dissect_tns_connect(tvbuff_t *tvb, int offset, packet_info *pinfo _U
 
 	if ( cd_len > 0)
 	{
+		/* connect data too long for the Connect packet is sent in the
+		 * Data packet that follows, see dissect_tns_connect_data() */
+		if ( tvb_reported_length_remaining(tvb, tns_offset+cd_offset) <= 0 )
+		{
+			if ( !PINFO_FD_VISITED(pinfo) )
+			{
+				tns_info->connect_data_len = cd_len;
+			}
+			return;
+		}
+
 		proto_tree_add_item(connect_tree, hf_tns_connect_data, tvb,
 			tns_offset+cd_offset, -1, ENC_ASCII);
+		tns_add_connect_descriptor(tvb, tns_offset+cd_offset, (gint) cd_len, pinfo, connect_tree, tns_info);
+	}
+}
+
+/*
+ * Connect data of a Connect that did not carry it, in the next Data
+ * packet of the client. Returns FALSE for any other Data packet.
+ */
+static gboolean dissect_tns_connect_data(tvbuff_t *tvb, int offset, packet_info *pinfo, proto_tree *tns_tree, tns_conv_info_t *tns_info)
+{
+	tns_pdu_info_t *pdu_info;
+	proto_tree *connect_tree;
+
+	if ( !PINFO_FD_VISITED(pinfo) && tns_info->connect_data_len > 0 && tns_is_request(pinfo, tns_info) )
+	{
+		tns_get_pdu_info(pinfo)->connect_data = TRUE;
+		tns_info->connect_data_len = 0;
 	}
+
+	pdu_info = tns_find_pdu_info(pinfo);
+	if ( !pdu_info || !pdu_info->connect_data )
+	{
+		return FALSE;
+	}
+
+	col_append_str(pinfo->cinfo, COL_INFO, " (Connect Data)");
+	connect_tree = proto_tree_add_subtree(tns_tree, tvb, offset, -1,
+		ett_tns_connect, NULL, "Connect Data");
+
+	proto_tree_add_item(connect_tree, hf_tns_data_flag, tvb, offset, 2, ENC_BIG_ENDIAN);
+	offset += 2;
+
+	if ( tvb_reported_length_remaining(tvb, offset) > 0 )
+	{
+		proto_tree_add_item(connect_tree, hf_tns_connect_data, tvb, offset, -1, ENC_ASCII);
+		tns_add_connect_descriptor(tvb, offset, tvb_reported_length_remaining(tvb, offset), pinfo, connect_tree, tns_info);
+	}
+
+	return TRUE;
 }
 
-static void dissect_tns_accept(tvbuff_t *tvb, int offset, packet_info *pinfo _U_, proto_tree *tns_tree)
+static void dissect_tns_accept(tvbuff_t *tvb, int offset, packet_info *pinfo, proto_tree *tns_tree, tns_conv_info_t *tns_info)
 {
 	proto_tree *accept_tree;
 	guint32 accept_offset, accept_len;
+	guint32 version, sdu_size, tdu_size;
 	int tns_offset = offset-8;
 
 	accept_tree = proto_tree_add_subtree(tns_tree, tvb, offset, -1,
 		    ett_tns_accept, NULL, "Accept");
 
-	proto_tree_add_item(accept_tree, hf_tns_version, tvb,
-			offset, 2, ENC_BIG_ENDIAN);
+	proto_tree_add_item_ret_uint(accept_tree, hf_tns_version, tvb,
+			offset, 2, ENC_BIG_ENDIAN, &version);
 	offset += 2;
 
 	proto_tree_add_bitmask(accept_tree, tvb, offset, hf_tns_service_options, ett_tns_sopt_flag, tns_service_options, ENC_BIG_ENDIAN);
 	offset += 2;
 
-	proto_tree_add_item(accept_tree, hf_tns_sdu_size, tvb,
-			offset, 2, ENC_BIG_ENDIAN);
+	proto_tree_add_item_ret_uint(accept_tree, hf_tns_sdu_size, tvb,
+			offset, 2, ENC_BIG_ENDIAN, &sdu_size);
 	offset += 2;
 
-	proto_tree_add_item(accept_tree, hf_tns_max_tdu_size, tvb,
-			offset, 2, ENC_BIG_ENDIAN);
+	proto_tree_add_item_ret_uint(accept_tree, hf_tns_max_tdu_size, tvb,
+			offset, 2, ENC_BIG_ENDIAN, &tdu_size);
 	offset += 2;
 
+	/* negotiated values, they drive the framing of all later packets */
+	if ( !PINFO_FD_VISITED(pinfo) )
+	{
+		tns_info->accept_frame = pinfo->num;
+		tns_info->version = version;
+		tns_info->sdu_size = sdu_size;
+		tns_info->tdu_size = tdu_size;
+	}
+
 	proto_tree_add_item(accept_tree, hf_tns_value_of_one, tvb,
 			offset, 2, ENC_NA);
 	offset += 2;
@@ -2024,6 +6142,19 @@ static void dissect_tns_accept(tvbuff_t *tvb, int offset, packet_info *pinfo _U_
 	proto_tree_add_bitmask(accept_tree, tvb, offset, hf_tns_connect_flags1, ett_tns_conn_flag, tns_connect_flags, ENC_BIG_ENDIAN);
 	/* offset += 1; */
 
+	/* From version 315 on the SDU size has 32 bit, 32 bytes into the
+	 * packet, ahead of the accept data */
+	if ( version >= TNS_VERSION_LARGE_SDU && (accept_len == 0 || accept_offset >= 36) &&
+	     tvb_bytes_exist(tvb, tns_offset + 32, 4) )
+	{
+		proto_tree_add_item_ret_uint(accept_tree, hf_tns_sdu_size_large, tvb,
+			tns_offset + 32, 4, ENC_BIG_ENDIAN, &sdu_size);
+		if ( !PINFO_FD_VISITED(pinfo) )
+		{
+			tns_info->sdu_size = sdu_size;
+		}
+	}
+
 	if ( accept_len > 0)
 	{
 		proto_tree_add_item(accept_tree, hf_tns_accept_data, tvb,
@@ -2107,9 +6238,91 @@ static void dissect_tns_marker(tvbuff_t *tvb, int offset, packet_info *pinfo _U_
 	/*offset += 1;*/
 }
 
-static void dissect_tns_redirect(tvbuff_t *tvb, int offset, packet_info *pinfo _U_, proto_tree *tns_tree)
+/*
+ * Value of the first (KEY=value) pair with the given key in a connect
+ * descriptor. Keys match case insensitively, blanks around the key and
+ * the value are ignored. Returns NULL if the key is not present.
+ */
+static gchar *tns_descriptor_value(wmem_allocator_t *scope, const gchar *desc, const gchar *key)
+{
+	size_t key_len = strlen(key);
+	const gchar *p, *value, *end;
+
+	for (p = strchr(desc, '('); p; p = strchr(p + 1, '('))
+	{
+		p++;
+		while (g_ascii_isspace(*p))
+			p++;
+		if (g_ascii_strncasecmp(p, key, key_len) != 0)
+			continue;
+
+		value = p + key_len;
+		while (g_ascii_isspace(*value))
+			value++;
+		if (*value != '=')
+			continue;
+
+		value++;
+		while (g_ascii_isspace(*value))
+			value++;
+		for (end = value; *end && *end != '(' && *end != ')'; end++)
+			;
+		while (end > value && g_ascii_isspace(end[-1]))
+			end--;
+
+		return wmem_strndup(scope, value, end - value);
+	}
+
+	return NULL;
+}
+
+/*
+ * The client is redirected to another TCP endpoint (shared server
+ * dispatcher, RAC instance behind a SCAN listener) and opens a new
+ * connection to it. That connection is registered as a TNS conversation
+ * up front, from the client address to the target with any client port.
+ * A host name can not be resolved here, the listener's address is taken
+ * then, which is right for the dispatchers on the listener's host.
+ */
+static void tns_follow_redirect(packet_info *pinfo, const gchar *host, guint16 port)
+{
+	conversation_t *conversation;
+	tns_conv_info_t *tns_info;
+	address server_addr;
+	ws_in4_addr ipv4;
+	ws_in6_addr ipv6;
+
+	if (ws_inet_pton4(host, &ipv4))
+		set_address(&server_addr, AT_IPv4, 4, &ipv4);
+	else if (ws_inet_pton6(host, &ipv6))
+		set_address(&server_addr, AT_IPv6, 16, &ipv6);
+	else
+		copy_address_shallow(&server_addr, &pinfo->src);
+
+	conversation = find_conversation(pinfo->num, &server_addr, &pinfo->dst,
+			CONVERSATION_TCP, port, 0, NO_PORT_B);
+	if (conversation == NULL || conversation_get_dissector(conversation, pinfo->num) != tns_handle)
+	{
+		conversation = conversation_new(pinfo->num, &server_addr, &pinfo->dst,
+				CONVERSATION_TCP, port, 0, NO_PORT2);
+		conversation_set_dissector(conversation, tns_handle);
+	}
+
+	tns_info = tns_conversation_get_info(conversation);
+	if (tns_info->server_port == 0)
+	{
+		copy_address_wmem(wmem_file_scope(), &tns_info->server_addr, &server_addr);
+		tns_info->server_port = port;
+	}
+}
+
+static void dissect_tns_redirect(tvbuff_t *tvb, int offset, packet_info *pinfo, proto_tree *tns_tree)
 {
 	proto_tree *redirect_tree;
+	proto_item *pi;
+	const gchar *data, *host, *port_str;
+	gint data_len;
+	guint16 port;
 
 	redirect_tree = proto_tree_add_subtree(tns_tree, tvb, offset, -1,
 		    ett_tns_redirect, NULL, "Redirect");
@@ -2118,8 +6331,24 @@ static void dissect_tns_redirect(tvbuff_t *tvb, int offset, packet_info *pinfo _
 			offset, 2, ENC_BIG_ENDIAN);
 	offset += 2;
 
-	proto_tree_add_item(redirect_tree, hf_tns_redirect_data, tvb,
-			offset, -1, ENC_ASCII);
+	proto_tree_add_item_ret_string_and_length(redirect_tree, hf_tns_redirect_data, tvb,
+			offset, -1, ENC_ASCII, pinfo->pool, (const guint8 **) &data, &data_len);
+
+	/* (ADDRESS=(PROTOCOL=TCP)(HOST=..)(PORT=..)) of the new endpoint */
+	host = tns_descriptor_value(pinfo->pool, data, "HOST");
+	port_str = tns_descriptor_value(pinfo->pool, data, "PORT");
+	if (host == NULL || port_str == NULL || !ws_strtou16(port_str, NULL, &port) || port == 0)
+		return;
+
+	pi = proto_tree_add_string(redirect_tree, hf_tns_redirect_host, tvb, offset, data_len, host);
+	proto_item_set_generated(pi);
+	pi = proto_tree_add_uint(redirect_tree, hf_tns_redirect_port, tvb, offset, data_len, port);
+	proto_item_set_generated(pi);
+
+	if (!PINFO_FD_VISITED(pinfo))
+	{
+		tns_follow_redirect(pinfo, host, port);
+	}
 }
 
 static void dissect_tns_control(tvbuff_t *tvb, int offset, packet_info *pinfo _U_, proto_tree *tns_tree)
@@ -2155,8 +6384,8 @@ static guint get_tns_pdu_len_nochksum(packet_info *pinfo _U_, tvbuff_t *tvb, int
 
 static int dissect_tns(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void *data)
 {
+	tns_conv_info_t *tns_info;
 	guint32 length;
-	guint16 chksum;
 	guint8  type;
 
 	/*
@@ -2183,10 +6412,13 @@ static int dissect_tns(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void
 	 *
 	 * Else, Oracle 12c combine these two 16-bit numbers into one 32-bit.
 	 * This number represents the packet length. Checksum is omitted.
+	 *
+	 * Which one applies follows from the version negotiated in the
+	 * Accept, see tns_length_field_size().
 	 */
-	chksum = tvb_get_ntohs(tvb, 2);
+	tns_info = tns_get_conv_info(pinfo);
 
-	length = (chksum == 0 || chksum == 4) ? 2 : 4;
+	length = tns_length_field_size(tvb, pinfo, tns_info);
 
 	tcp_dissect_pdus(tvb, pinfo, tree, tns_desegment, length,
 			(length == 2 ? get_tns_pdu_len : get_tns_pdu_len_nochksum),
@@ -2195,24 +6427,89 @@ static int dissect_tns(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void
 	return tvb_captured_length(tvb);
 }
 
+/*
+ * TNS on other ports than 1521. A session starts with a Connect from the
+ * client, answered with an Accept (or a Refuse or Redirect), both in a
+ * packet of their own and with a 16 bit length. Their fixed header is
+ * checked from one fetch: the length matches the segment, the packet
+ * checksum is 0 (or 4 from some 10g clients), the type is Connect or
+ * Accept, the reserved byte and the header checksum are 0 and the TNS
+ * version is in the known range. The conversation is then handed to the
+ * TNS dissector, so later packets bypass the heuristics.
+ */
+#define TNS_HEUR_MIN_LEN   10   /* header and version */
+#define TNS_VERSION_MIN    300
+#define TNS_VERSION_MAX    399
+
+static gboolean dissect_tns_heur(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void *data)
+{
+	conversation_t *conversation;
+	tns_conv_info_t *tns_info;
+	const guint8 *hdr;
+	guint16 version;
+
+	if (tvb_captured_length(tvb) < TNS_HEUR_MIN_LEN)
+		return FALSE;
+
+	hdr = tvb_get_ptr(tvb, 0, TNS_HEUR_MIN_LEN);
+
+	if (hdr[4] != TNS_TYPE_CONNECT && hdr[4] != TNS_TYPE_ACCEPT)
+		return FALSE;
+	if (hdr[2] != 0 || (hdr[3] != 0 && hdr[3] != 4) || hdr[5] != 0 || hdr[6] != 0 || hdr[7] != 0)
+		return FALSE;
+	if (pntoh16(&hdr[0]) != tvb_reported_length(tvb))
+		return FALSE;
+
+	version = pntoh16(&hdr[8]);
+	if (version < TNS_VERSION_MIN || version > TNS_VERSION_MAX)
+		return FALSE;
+
+	conversation = find_or_create_conversation(pinfo);
+	conversation_set_dissector(conversation, tns_handle);
+
+	tns_info = tns_get_conv_info(pinfo);
+	if (tns_info->server_port == 0)
+	{
+		/* the Connect is sent to the listener, the Accept by it */
+		if (hdr[4] == TNS_TYPE_CONNECT)
+		{
+			copy_address_wmem(wmem_file_scope(), &tns_info->server_addr, &pinfo->dst);
+			tns_info->server_port = pinfo->destport;
+		}
+		else
+		{
+			copy_address_wmem(wmem_file_scope(), &tns_info->server_addr, &pinfo->src);
+			tns_info->server_port = pinfo->srcport;
+		}
+	}
+
+	dissect_tns(tvb, pinfo, tree, data);
+
+	return TRUE;
+}
+
 static int dissect_tns_pdu(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void* data _U_)
 {
 	proto_tree *tns_tree, *ti;
 	proto_item *hidden_item;
+	tns_conv_info_t *tns_info;
+	gboolean is_request;
 	int offset = 0;
 	guint32 length;
-	guint16 chksum;
 	guint8  type;
 
+	tns_start_pdu(pinfo);
+	tns_info = tns_get_conv_info(pinfo);
+	is_request = tns_is_request(pinfo, tns_info);
+
 	col_set_str(pinfo->cinfo, COL_PROTOCOL, "TNS");
 
-	col_set_str(pinfo->cinfo, COL_INFO,
-			(pinfo->match_uint == pinfo->destport) ? "Request" : "Response");
+	col_set_str(pinfo->cinfo, COL_INFO, is_request ? "Request" : "Response");
 
 	ti = proto_tree_add_item(tree, proto_tns, tvb, 0, -1, ENC_NA);
 	tns_tree = proto_item_add_subtree(ti, ett_tns);
 
-	if (pinfo->match_uint == pinfo->destport)
+	if (is_request)
 	{
 		hidden_item = proto_tree_add_boolean(tns_tree, hf_tns_request,
 					tvb, offset, 0, TRUE);
@@ -2224,8 +6521,7 @@ static int dissect_tns_pdu(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree,
 	}
 	proto_item_set_hidden(hidden_item);
 
-	chksum = tvb_get_ntohs(tvb, offset+2);
-	if (chksum == 0 || chksum == 4)
+	if (tns_length_field_size(tvb, pinfo, tns_info) == 2)
 	{
 		proto_tree_add_item_ret_uint(tns_tree, hf_tns_length, tvb, offset,
 					2, ENC_BIG_ENDIAN, &length);
@@ -2257,13 +6553,19 @@ static int dissect_tns_pdu(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree,
 	proto_tree_add_checksum(tns_tree, tvb, offset, hf_tns_header_checksum, -1, NULL, pinfo, 0, ENC_BIG_ENDIAN, PROTO_CHECKSUM_NO_FLAGS);
 	offset += 2;
 
+	if (type != TNS_TYPE_CONNECT)
+	{
+		tns_add_connect_values(tvb, tns_tree, tns_info);
+	}
+	tns_add_session_values(tvb, pinfo, tns_tree, tns_info);
+
 	switch (type)
 	{
 		case TNS_TYPE_CONNECT:
-			dissect_tns_connect(tvb,offset,pinfo,tns_tree);
+			dissect_tns_connect(tvb,offset,pinfo,tns_tree,tns_info);
 			break;
 		case TNS_TYPE_ACCEPT:
-			dissect_tns_accept(tvb,offset,pinfo,tns_tree);
+			dissect_tns_accept(tvb,offset,pinfo,tns_tree,tns_info);
 			break;
 		case TNS_TYPE_REFUSE:
 			dissect_tns_refuse(tvb,offset,pinfo,tns_tree);
@@ -2284,7 +6586,8 @@ static int dissect_tns_pdu(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree,
 			dissect_tns_control(tvb,offset,pinfo,tns_tree);
 			break;
 		case TNS_TYPE_DATA:
-			dissect_tns_data(tvb,offset,pinfo,tns_tree);
+			if ( !dissect_tns_connect_data(tvb,offset,pinfo,tns_tree,tns_info) )
+				dissect_tns_data(tvb,offset,pinfo,tns_tree,tns_info);
 			break;
 		default:
 			call_data_dissector(tvb_new_subset_remaining(tvb, offset), pinfo,
@@ -2295,6 +6598,51 @@ static int dissect_tns_pdu(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree,
 	return tvb_captured_length(tvb);
 }
 
+#ifdef _DISSECTOR_SQL_DEBUG
+/* Statements that must (or must not) share their fingerprint */
+static const struct {
+	const gchar *sql1;
+	const gchar *sql2;
+	gboolean same;
+} tns_sql_norm_samples[] = {
+	{ "select * from emp where id = 42", "SELECT *\n  FROM emp WHERE id=7 -- c", TRUE },
+	{ "select a from t where x in (1, 2, 3)", "select a from t where x in ( 4 ,5 )", TRUE },
+	{ "select count ( * ) from t", "/*+ hint */ SELECT count(*) FROM t", TRUE },
+	/* bind variables, adjacent to operators or not */
+	{ "select * from t where id=:1", "select * from t where id = :1", TRUE },
+	{ "select * from t where id=:b1 and x<>:b2", "select * from t where id = :B1 and x <> :b2", TRUE },
+	{ "begin :x:=:y; end;", "begin :x := :y ; end ;", TRUE },
+	{ "select * from t where id = :1", "select * from t where id = :2", FALSE },
+	/* signed literals behind operators */
+	{ "select * from t where x=-1", "select * from t where x = - 2", TRUE },
+	{ "select * from t where x>=-1.5", "select * from t where x >= -3", TRUE },
+	{ "update t set x=x*-1", "update t set x = x * -2", TRUE },
+	{ "select * from t where x = -1", "select * from t where x = 1", FALSE },
+	{ "select * from t where x<=1", "select * from t where x< =1", FALSE },
+};
+
+/* Check the normalizer against the samples, complaints go to stdout */
+static void tns_sql_norm_check(void)
+{
+	for (guint k = 0; k < array_length(tns_sql_norm_samples); k++)
+	{
+		guint64 fp1, fp2;
+		const gchar *verb;
+		gchar *norm1, *norm2;
+
+		norm1 = tns_sql_normalize(NULL, tns_sql_norm_samples[k].sql1, &fp1, &verb);
+		norm2 = tns_sql_normalize(NULL, tns_sql_norm_samples[k].sql2, &fp2, &verb);
+		if ( (fp1 == fp2) != tns_sql_norm_samples[k].same )
+		{
+			fprintf(stdout, "%s: sample %u: fingerprints %s: [%s] [%s]\n",
+				__func__, k, tns_sql_norm_samples[k].same ? "differ" : "match", norm1, norm2);
+		}
+		wmem_free(NULL, norm1);
+		wmem_free(NULL, norm2);
+	}
+}
+#endif
+
 void proto_register_tns(void)
 {
 	static hf_register_info hf[] = {
@@ -2363,6 +6711,9 @@ void proto_register_tns(void)
 		{ &hf_tns_sdu_size, {
 			"Session Data Unit Size", "tns.sdu_size", FT_UINT16, BASE_DEC,
 			NULL, 0x0, NULL, HFILL }},
+		{ &hf_tns_sdu_size_large, {
+			"Session Data Unit Size (32 bit)", "tns.sdu_size_large", FT_UINT32, BASE_DEC,
+			NULL, 0x0, NULL, HFILL }},
 		{ &hf_tns_max_tdu_size, {
 			"Maximum Transmission Data Unit Size", "tns.max_tdu_size", FT_UINT16, BASE_DEC,
 			NULL, 0x0, NULL, HFILL }},
@@ -2470,7 +6821,25 @@ void proto_register_tns(void)
 			NULL, 0x0, NULL, HFILL }},
 		{ &hf_tns_connect_data, {
 			"Connect Data", "tns.connect_data", FT_STRING, BASE_NONE,
-			NULL, 0x0, NULL, HFILL }},
+			NULL, 0x0, "Connect descriptor, in the Connect or, if too long for it, in the Data packet that follows", HFILL }},
+		{ &hf_tns_connect_service_name, {
+			"Service Name", "tns.connect.service_name", FT_STRING, BASE_NONE,
+			NULL, 0x0, "SERVICE_NAME of the session's connect data", HFILL }},
+		{ &hf_tns_connect_sid, {
+			"SID", "tns.connect.sid", FT_STRING, BASE_NONE,
+			NULL, 0x0, "SID of the session's connect data", HFILL }},
+		{ &hf_tns_connect_cid, {
+			"Client Identity", "tns.connect.cid", FT_STRING, BASE_NONE,
+			NULL, 0x0, "CID of the session's connect data", HFILL }},
+		{ &hf_tns_connect_program, {
+			"Client Program", "tns.connect.program", FT_STRING, BASE_NONE,
+			NULL, 0x0, "PROGRAM of the client identity", HFILL }},
+		{ &hf_tns_connect_host, {
+			"Client Host", "tns.connect.host", FT_STRING, BASE_NONE,
+			NULL, 0x0, "HOST of the client identity", HFILL }},
+		{ &hf_tns_connect_user, {
+			"Client OS User", "tns.connect.user", FT_STRING, BASE_NONE,
+			NULL, 0x0, "USER of the client identity", HFILL }},
 
 		{ &hf_tns_accept_data_length, {
 			"Accept Data Length", "tns.accept_data_length", FT_UINT16, BASE_DEC,
@@ -2530,6 +6899,12 @@ void proto_register_tns(void)
 		{ &hf_tns_redirect_data, {
 			"Redirect Data", "tns.redirect_data", FT_STRING, BASE_NONE,
 			NULL, 0x0, NULL, HFILL }},
+		{ &hf_tns_redirect_host, {
+			"Redirect Host", "tns.redirect_host", FT_STRING, BASE_NONE,
+			NULL, 0x0, "Host the client is redirected to", HFILL }},
+		{ &hf_tns_redirect_port, {
+			"Redirect Port", "tns.redirect_port", FT_UINT16, BASE_DEC,
+			NULL, 0x0, "TCP port the client is redirected to", HFILL }},
 
 		{ &hf_tns_data_flag, {
 			"Data Flag", "tns.data_flag", FT_UINT16, BASE_HEX,
@@ -2599,72 +6974,74 @@ void proto_register_tns(void)
 		{ &hf_tns_data_ttic_param_count, {
 			"TTC/TTI Parameter count", "tns.data_ttic_param_count", FT_UINT8, BASE_DEC,
 			NULL, 0x00, NULL, HFILL }},
-
-		{ &hf_tns_data_ttic_stmt_sql, {
-			"TTC/TTI SQL statement", "tns.data_ttic_stmt_sql", FT_STRINGZ, BASE_NONE,
-			NULL, 0x00, NULL, HFILL }},
-
-		{ &hf_tns_data_ttic_stmt_sql_p01, {
-			"SQL Parameter 1", "tns.data_ttic_stmt_sql_p01", FT_STRINGZ, BASE_NONE,
-			NULL, 0x00, NULL, HFILL }},
-		{ &hf_tns_data_ttic_stmt_sql_p02, {
-			"SQL Parameter 2", "tns.data_ttic_stmt_sql_p02", FT_STRINGZ, BASE_NONE,
-			NULL, 0x00, NULL, HFILL }},
-		{ &hf_tns_data_ttic_stmt_sql_p03, {
-			"SQL Parameter 3", "tns.data_ttic_stmt_sql_p03", FT_STRINGZ, BASE_NONE,
-			NULL, 0x00, NULL, HFILL }},
-		{ &hf_tns_data_ttic_stmt_sql_p04, {
-			"SQL Parameter 4", "tns.data_ttic_stmt_sql_p04", FT_STRINGZ, BASE_NONE,
-			NULL, 0x00, NULL, HFILL }},
-		{ &hf_tns_data_ttic_stmt_sql_p05, {
-			"SQL Parameter 5", "tns.data_ttic_stmt_sql_p05", FT_STRINGZ, BASE_NONE,
-			NULL, 0x00, NULL, HFILL }},
-		{ &hf_tns_data_ttic_stmt_sql_p06, {
-			"SQL Parameter 6", "tns.data_ttic_stmt_sql_p06", FT_STRINGZ, BASE_NONE,
+		{ &hf_tns_oall8_token, {
+			"Token Number", "tns.oall8.token", FT_UINT64, BASE_DEC,
 			NULL, 0x00, NULL, HFILL }},
-		{ &hf_tns_data_ttic_stmt_sql_p07, {
-			"SQL Parameter 7", "tns.data_ttic_stmt_sql_p07", FT_STRINGZ, BASE_NONE,
+		{ &hf_tns_oall8_options, {
+			"Execute Options", "tns.oall8.options", FT_UINT32, BASE_HEX,
 			NULL, 0x00, NULL, HFILL }},
-		{ &hf_tns_data_ttic_stmt_sql_p08, {
-			"SQL Parameter 8", "tns.data_ttic_stmt_sql_p08", FT_STRINGZ, BASE_NONE,
+		{ &hf_tns_oall8_cursor, {
+			"Cursor", "tns.oall8.cursor", FT_UINT32, BASE_DEC,
+			NULL, 0x00, "Cursor of the call, 0 to open a new one", HFILL }},
+		{ &hf_tns_oall8_sql_length, {
+			"SQL Length", "tns.oall8.sql_length", FT_UINT32, BASE_DEC,
 			NULL, 0x00, NULL, HFILL }},
-		{ &hf_tns_data_ttic_stmt_sql_p09, {
-			"SQL Parameter 9", "tns.data_ttic_stmt_sql_p09", FT_STRINGZ, BASE_NONE,
+		{ &hf_tns_oall8_al8i4_length, {
+			"al8i4 Length", "tns.oall8.al8i4_length", FT_UINT32, BASE_DEC,
 			NULL, 0x00, NULL, HFILL }},
-		{ &hf_tns_data_ttic_stmt_sql_p10, {
-			"SQL Parameter 10", "tns.data_ttic_stmt_sql_p10", FT_STRINGZ, BASE_NONE,
+		{ &hf_tns_oall8_prefetch_rows, {
+			"Prefetch Rows", "tns.oall8.prefetch_rows", FT_UINT32, BASE_DEC,
 			NULL, 0x00, NULL, HFILL }},
-		{ &hf_tns_data_ttic_stmt_sql_p11, {
-			"SQL Parameter 11", "tns.data_ttic_stmt_sql_p11", FT_STRINGZ, BASE_NONE,
+		{ &hf_tns_oall8_max_long_size, {
+			"Maximum Long Size", "tns.oall8.max_long_size", FT_UINT32, BASE_DEC,
 			NULL, 0x00, NULL, HFILL }},
-		{ &hf_tns_data_ttic_stmt_sql_p12, {
-			"SQL Parameter 12", "tns.data_ttic_stmt_sql_p12", FT_STRINGZ, BASE_NONE,
+		{ &hf_tns_oall8_bind_count, {
+			"Bind Count", "tns.oall8.bind_count", FT_UINT32, BASE_DEC,
 			NULL, 0x00, NULL, HFILL }},
-		{ &hf_tns_data_ttic_stmt_sql_p13, {
-			"SQL Parameter 13", "tns.data_ttic_stmt_sql_p13", FT_STRINGZ, BASE_NONE,
+		{ &hf_tns_oall8_define_count, {
+			"Define Count", "tns.oall8.define_count", FT_UINT32, BASE_DEC,
 			NULL, 0x00, NULL, HFILL }},
-		{ &hf_tns_data_ttic_stmt_sql_p14, {
-			"SQL Parameter 14", "tns.data_ttic_stmt_sql_p14", FT_STRINGZ, BASE_NONE,
-			NULL, 0x00, NULL, HFILL }},
-		{ &hf_tns_data_ttic_stmt_sql_p15, {
-			"SQL Parameter 15", "tns.data_ttic_stmt_sql_p15", FT_STRINGZ, BASE_NONE,
-			NULL, 0x00, NULL, HFILL }},
-		{ &hf_tns_data_ttic_stmt_sql_p16, {
-			"SQL Parameter 16", "tns.data_ttic_stmt_sql_p16", FT_STRINGZ, BASE_NONE,
-			NULL, 0x00, NULL, HFILL }},
-		{ &hf_tns_data_ttic_stmt_sql_p17, {
-			"SQL Parameter 17", "tns.data_ttic_stmt_sql_p17", FT_STRINGZ, BASE_NONE,
-			NULL, 0x00, NULL, HFILL }},
-		{ &hf_tns_data_ttic_stmt_sql_p18, {
-			"SQL Parameter 18", "tns.data_ttic_stmt_sql_p18", FT_STRINGZ, BASE_NONE,
+
+		{ &hf_tns_data_ttic_stmt_sql, {
+			"TTC/TTI SQL statement", "tns.data_ttic_stmt_sql", FT_STRINGZ, BASE_NONE,
 			NULL, 0x00, NULL, HFILL }},
-		{ &hf_tns_data_ttic_stmt_sql_p19, {
-			"SQL Parameter 19", "tns.data_ttic_stmt_sql_p19", FT_STRINGZ, BASE_NONE,
+
+		{ &hf_tns_bind_index, {
+			"Bind Index", "tns.bind.index", FT_UINT32, BASE_DEC,
+			NULL, 0x00, "Position of the bind value in the statement, starting at 1", HFILL }},
+
+		{ &hf_tns_bind_type, {
+			"Bind Type", "tns.bind.type", FT_UINT8, BASE_DEC,
+			VALS(ttci_bind_kinds), 0x00, NULL, HFILL }},
+
+		{ &hf_tns_bind_length, {
+			"Bind Length", "tns.bind.length", FT_UINT32, BASE_DEC,
 			NULL, 0x00, NULL, HFILL }},
-		{ &hf_tns_data_ttic_stmt_sql_p20, {
-			"SQL Parameter 20", "tns.data_ttic_stmt_sql_p20", FT_STRINGZ, BASE_NONE,
+
+		{ &hf_tns_bind_value, {
+			"Bind Value", "tns.bind.value", FT_STRING, BASE_NONE,
 			NULL, 0x00, NULL, HFILL }},
 
+		{ &hf_tns_bind_data, {
+			"Bind Data", "tns.bind.data", FT_BYTES, BASE_NONE,
+			NULL, 0x00, "Raw value of a bind that is not decoded", HFILL }},
+
+		{ &hf_tns_bind_number, {
+			"Bind Number", "tns.bind.number", FT_DOUBLE, BASE_NONE,
+			NULL, 0x00, "Value of a NUMBER bind", HFILL }},
+
+		{ &hf_tns_bind_integer, {
+			"Bind Integer", "tns.bind.integer", FT_INT64, BASE_DEC,
+			NULL, 0x00, "Value of an integral NUMBER bind", HFILL }},
+
+		{ &hf_tns_bind_time, {
+			"Bind Time", "tns.bind.time", FT_ABSOLUTE_TIME, ABSOLUTE_TIME_UTC,
+			NULL, 0x00, "Value of a DATE or TIMESTAMP bind", HFILL }},
+
+		{ &hf_tns_bind_tz_offset, {
+			"Bind Time Zone Offset", "tns.bind.tz_offset", FT_INT32, BASE_DEC,
+			NULL, 0x00, "Time zone of a TIMESTAMP WITH TIME ZONE bind, in minutes east of UTC", HFILL }},
+
 /* TTC/TTI: END ========================================================= */
 
 		{ &hf_tns_data_piggyback_id, {
@@ -2691,6 +7068,69 @@ void proto_register_tns(void)
 			"Server Banner", "tns.data_setp_resp.banner", FT_STRINGZ, BASE_NONE,
 			NULL, 0x0, NULL, HFILL }},
 
+		{ &hf_tns_data_sdty_ttc_field_version, {
+			"TTC Field Version", "tns.data_sdty_req.ttc_field_version", FT_UINT8, BASE_DEC,
+			NULL, 0x0, "TTC field version from the compile time capabilities", HFILL }},
+
+		{ &hf_tns_data_cursor_id, {
+			"Cursor ID", "tns.cursor.id", FT_UINT32, BASE_DEC,
+			NULL, 0x0, NULL, HFILL }},
+
+		{ &hf_tns_data_cursor_sql, {
+			"Cursor SQL Statement", "tns.cursor.sql", FT_STRING, BASE_NONE,
+			NULL, 0x0, "SQL statement the cursor was parsed for", HFILL }},
+
+		{ &hf_tns_data_cursor_parse_frame, {
+			"Cursor parsed in", "tns.cursor.parse_frame", FT_FRAMENUM, BASE_NONE,
+			NULL, 0x0, "Frame carrying the SQL statement of the cursor", HFILL }},
+
+		{ &hf_tns_data_cursor_closed, {
+			"Closed Cursor ID", "tns.cursor.closed", FT_UINT32, BASE_DEC,
+			NULL, 0x0, NULL, HFILL }},
+
+		{ &hf_tns_ttc_fragments, {
+			"TTC fragments", "tns.ttc.fragments", FT_NONE, BASE_NONE,
+			NULL, 0x0, NULL, HFILL }},
+		{ &hf_tns_ttc_fragment, {
+			"TTC fragment", "tns.ttc.fragment", FT_FRAMENUM, BASE_NONE,
+			NULL, 0x0, NULL, HFILL }},
+		{ &hf_tns_ttc_fragment_overlap, {
+			"TTC fragment overlap", "tns.ttc.fragment.overlap", FT_BOOLEAN, BASE_NONE,
+			NULL, 0x0, NULL, HFILL }},
+		{ &hf_tns_ttc_fragment_overlap_conflicts, {
+			"TTC fragment overlapping with conflicting data", "tns.ttc.fragment.overlap.conflicts", FT_BOOLEAN, BASE_NONE,
+			NULL, 0x0, NULL, HFILL }},
+		{ &hf_tns_ttc_fragment_multiple_tails, {
+			"TTC has multiple tail fragments", "tns.ttc.fragment.multiple_tails", FT_BOOLEAN, BASE_NONE,
+			NULL, 0x0, NULL, HFILL }},
+		{ &hf_tns_ttc_fragment_too_long_fragment, {
+			"TTC fragment too long", "tns.ttc.fragment.too_long_fragment", FT_BOOLEAN, BASE_NONE,
+			NULL, 0x0, NULL, HFILL }},
+		{ &hf_tns_ttc_fragment_error, {
+			"TTC defragmentation error", "tns.ttc.fragment.error", FT_FRAMENUM, BASE_NONE,
+			NULL, 0x0, NULL, HFILL }},
+		{ &hf_tns_ttc_fragment_count, {
+			"TTC fragment count", "tns.ttc.fragment.count", FT_UINT32, BASE_DEC,
+			NULL, 0x0, NULL, HFILL }},
+		{ &hf_tns_ttc_reassembled_in, {
+			"Reassembled TTC in frame", "tns.ttc.reassembled.in", FT_FRAMENUM, BASE_NONE,
+			NULL, 0x0, "This TTC message is reassembled in this frame", HFILL }},
+		{ &hf_tns_ttc_reassembled_length, {
+			"Reassembled TTC length", "tns.ttc.reassembled.length", FT_UINT32, BASE_DEC,
+			NULL, 0x0, "The total length of the reassembled payload", HFILL }},
+
+		{ &hf_tns_response_in, {
+			"Response In", "tns.response_in", FT_FRAMENUM, BASE_NONE,
+			FRAMENUM_TYPE(FT_FRAMENUM_RESPONSE), 0x0, "The response to this call is in this frame", HFILL }},
+
+		{ &hf_tns_response_to, {
+			"Response To", "tns.response_to", FT_FRAMENUM, BASE_NONE,
+			FRAMENUM_TYPE(FT_FRAMENUM_REQUEST), 0x0, "This is a response to the call in this frame", HFILL }},
+
+		{ &hf_tns_time, {
+			"Time", "tns.time", FT_RELATIVE_TIME, BASE_NONE,
+			NULL, 0x0, "The time between the call and the response", HFILL }},
+
 		{ &hf_tns_data_sns_cli_vers, {
 			"Client Version", "tns.data_sns.cli_vers", FT_UINT32, BASE_CUSTOM,
 			CF_FUNC(vsnum_to_vstext_basecustom), 0x0, NULL, HFILL }},
@@ -2723,6 +7163,57 @@ void proto_register_tns(void)
 		{ &hf_tns_data_opi_param_value, {
 			"Value", "tns.data_opi.param_value", FT_STRING, BASE_NONE,
 			NULL, 0x0, NULL, HFILL }},
+		{ &hf_tns_session_user, {
+			"Session User", "tns.session.user", FT_STRING, BASE_NONE,
+			NULL, 0x0, "Database user of the session", HFILL }},
+		{ &hf_tns_session_sid, {
+			"Session ID", "tns.session.sid", FT_UINT32, BASE_DEC,
+			NULL, 0x0, "Server session id (AUTH_SESSION_ID)", HFILL }},
+		{ &hf_tns_session_serial, {
+			"Session Serial Number", "tns.session.serial", FT_UINT32, BASE_DEC,
+			NULL, 0x0, "Server session serial number (AUTH_SERIAL_NUM)", HFILL }},
+		{ &hf_tns_session_program, {
+			"Session Program", "tns.session.program", FT_STRING, BASE_NONE,
+			NULL, 0x0, "Client program (AUTH_PROGRAM_NM)", HFILL }},
+		{ &hf_tns_session_machine, {
+			"Session Machine", "tns.session.machine", FT_STRING, BASE_NONE,
+			NULL, 0x0, "Client machine (AUTH_MACHINE)", HFILL }},
+		{ &hf_tns_session_terminal, {
+			"Session Terminal", "tns.session.terminal", FT_STRING, BASE_NONE,
+			NULL, 0x0, "Client terminal (AUTH_TERMINAL)", HFILL }},
+
+		{ &hf_tns_sql_fingerprint, {
+			"SQL Fingerprint", "tns.sql.fingerprint", FT_UINT64, BASE_HEX,
+			NULL, 0x0, "Hash of the statement with its literals replaced, same for statements differing in literals only", HFILL }},
+		{ &hf_tns_sql_verb, {
+			"SQL Verb", "tns.sql.verb", FT_STRING, BASE_NONE,
+			NULL, 0x0, "First keyword of the statement", HFILL }},
+
+		{ &hf_tns_parse_count, {
+			"Session Parses", "tns.parse.count", FT_UINT32, BASE_DEC,
+			NULL, 0x0, "Calls of the session that sent the text of a statement with this fingerprint so far", HFILL }},
+
+		{ &hf_tns_fetch_requested, {
+			"Rows Requested", "tns.fetch.requested", FT_UINT32, BASE_DEC,
+			NULL, 0x0, "Rows asked for by a fetch call", HFILL }},
+		{ &hf_tns_fetch_columns, {
+			"Select List Columns", "tns.fetch.columns", FT_UINT32, BASE_DEC,
+			NULL, 0x0, "Columns of the describe of a query", HFILL }},
+		{ &hf_tns_fetch_rows, {
+			"Rows", "tns.fetch.rows", FT_UINT32, BASE_DEC,
+			NULL, 0x0, "Rows returned by the response", HFILL }},
+		{ &hf_tns_fetch_end, {
+			"End of Fetch", "tns.fetch.end", FT_BOOLEAN, BASE_NONE,
+			NULL, 0x0, "No more rows pending after the response", HFILL }},
+		{ &hf_tns_fetch_cursor_fetches, {
+			"Cursor Fetches", "tns.fetch.cursor_fetches", FT_UINT32, BASE_DEC,
+			NULL, 0x0, "Responses with rows counted for the cursor so far", HFILL }},
+		{ &hf_tns_fetch_cursor_rows, {
+			"Cursor Rows", "tns.fetch.cursor_rows", FT_UINT64, BASE_DEC,
+			NULL, 0x0, "Rows fetched from the cursor so far", HFILL }},
+		{ &hf_tns_fetch_cursor_median, {
+			"Cursor Median Rows/Fetch", "tns.fetch.cursor_median", FT_UINT32, BASE_DEC,
+			NULL, 0x0, "Median rows of the cursor fetches that did not end the rows", HFILL }},
 
 		{ &hf_tns_reserved_byte, {
 			"Reserved Byte", "tns.reserved_byte", FT_BYTES, BASE_NONE,
@@ -2753,13 +7244,25 @@ void proto_register_tns(void)
 		&ett_tns_ntp_flag,
 		&ett_tns_conn_flag,
 		&ett_sql,
-		&ett_sql_params
+		&ett_sql_params,
+		&ett_sql_bind,
+		&ett_tns_ttc_fragment,
+		&ett_tns_ttc_fragments
+	};
+	static ei_register_info ei[] = {
+		{ &ei_tns_parse_repeated, { "tns.parse.repeated", PI_PERFORMANCE, PI_NOTE,
+			"Statement parsed again instead of re-executing its cursor", EXPFILL }},
+		{ &ei_tns_fetch_rows_low, { "tns.fetch.rows.low", PI_PERFORMANCE, PI_NOTE,
+			"Cursor fetched few rows per fetch", EXPFILL }},
 	};
 	module_t *tns_module;
+	expert_module_t *expert_tns;
 
 	proto_tns = proto_register_protocol("Transparent Network Substrate Protocol", "TNS", "tns");
 	proto_register_field_array(proto_tns, hf, array_length(hf));
 	proto_register_subtree_array(ett, array_length(ett));
+	expert_tns = expert_register_protocol(proto_tns);
+	expert_register_field_array(expert_tns, ei, array_length(ei));
 	tns_handle = register_dissector("tns", dissect_tns, proto_tns);
 
 	tns_module = prefs_register_protocol(proto_tns, NULL);
@@ -2768,11 +7271,42 @@ void proto_register_tns(void)
 	  "Whether the TNS dissector should reassemble messages spanning multiple TCP segments. "
 	  "To use this option, you must also enable \"Allow subdissectors to reassemble TCP streams\" in the TCP protocol settings.",
 	  &tns_desegment);
+	prefs_register_bool_preference(tns_module, "reassemble_ttc",
+	  "Reassemble TTC messages spanning multiple TNS Data packets",
+	  "Whether TTC messages larger than the session data unit are reassembled from the TNS Data packets carrying them.",
+	  &tns_ttc_reassemble);
+	prefs_register_uint_preference(tns_module, "cursor_cache_size",
+	  "Cursors tracked per conversation",
+	  "Maximum number of cursors per conversation whose SQL statement is remembered "
+	  "to annotate later execute, fetch and close calls. The least recently used cursor is dropped first.",
+	  10, &tns_cursor_cache_size);
+	prefs_register_uint_preference(tns_module, "fetch_rows_threshold",
+	  "Rows per fetch threshold",
+	  "Cursors whose median rows per fetch is below it are flagged at the end of their rows, "
+	  "as are statements in the Fetch Sizes statistics. Fetches that end the rows are left out.",
+	  10, &tns_fetch_rows_threshold);
+
+	reassembly_table_register(&tns_ttc_reassembly_table, &addresses_ports_reassembly_table_functions);
+
+	tns_sql_texts = wmem_map_new_autoreset(wmem_epan_scope(), wmem_file_scope(), g_str_hash, g_str_equal);
+#ifdef _DISSECTOR_SQL_DEBUG
+	tns_sql_norm_check();
+#endif
+
+	tns_tap = register_tap("tns");
+	register_stat_tap_table_ui(&tns_sql_stat_table);
+	register_stat_tap_table_ui(&tns_rtt_stat_table);
+	register_stat_tap_table_ui(&tns_fetch_stat_table);
+	register_stat_tap_table_ui(&tns_parse_stat_table);
+
+	tns_srt_tap = register_tap("tns_srt");
+	register_srt_table(proto_tns, "tns_srt", 1, tns_srt_packet, tns_srt_init, NULL);
 }
 
 void proto_reg_handoff_tns(void)
 {
 	dissector_add_uint_with_preference("tcp.port", TCP_PORT_TNS, tns_handle);
+	heur_dissector_add("tcp", dissect_tns_heur, "TNS over TCP", "tns_tcp", proto_tns, HEURISTIC_ENABLE);
 }
 
 /*